@@ -10,9 +10,12 @@
 #include "base/callback.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/md5.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_filter.h"
 #include "base/sequenced_task_runner.h"
 #include "base/threading/sequenced_worker_pool.h"
@@ -22,6 +25,123 @@ namespace {
 
 // Some extensions we'll tack on to copies of the Preferences files.
 const base::FilePath::CharType* kBadExtension = FILE_PATH_LITERAL("bad");
+const base::FilePath::CharType* kJournalExtension =
+    FILE_PATH_LITERAL("journal");
+
+// The journal holds one JSON record per line, each giving the new value of
+// the pref at |kJournalPathKey|, or no value if it was removed. Applying the
+// records in order to the preferences file they were written against gives
+// the current prefs. A crash can only tear the last record, which is
+// dropped on load.
+//
+// The first line is a header giving the MD5 of the preferences file the
+// journal was started against, at |kJournalBaseHashKey|. A journal whose
+// file has since been rewritten, e.g. by a version that does not know about
+// journals, is discarded rather than applied to newer prefs.
+//
+// Before the file is rewritten, all pending changes are appended to the
+// journal, so that each pref's last record matches the new file. A crash
+// between writing the file and deleting the journal then leaves a journal
+// which is a no-op on top of the file.
+const char kJournalBaseHashKey[] = "base_md5";
+const char kJournalPathKey[] = "path";
+const char kJournalValueKey[] = "value";
+
+// The journal is always allowed to grow to this size before the file is
+// rewritten, however small the file.
+const int64 kMinJournalSizeToRewrite = 64 * 1024;
+
+base::FilePath GetJournalPath(const base::FilePath& path) {
+  return path.AddExtension(kJournalExtension);
+}
+
+// Returns the journal header for a preferences file holding |contents|.
+std::string GetJournalHeader(const std::string& contents) {
+  base::DictionaryValue header;
+  header.SetStringWithoutPathExpansion(kJournalBaseHashKey,
+                                       base::MD5String(contents));
+  std::string line;
+  JSONStringValueSerializer serializer(&line);
+  if (!serializer.Serialize(header))
+    return std::string();
+  line.push_back('\n');
+  return line;
+}
+
+// Applies the journal of the preferences file at |path| to |prefs|, dropping
+// a torn or corrupt tail, and returns the size of the journal applied. A
+// journal started against another version of the file is deleted.
+int64 ReplayJournal(const base::FilePath& path,
+                    base::DictionaryValue* prefs) {
+  base::FilePath journal_path = GetJournalPath(path);
+  std::string journal;
+  if (!base::ReadFileToString(journal_path, &journal))
+    return 0;
+
+  std::string contents;
+  std::string header;
+  if (base::ReadFileToString(path, &contents))
+    header = GetJournalHeader(contents);
+  if (header.empty() || journal.compare(0, header.size(), header) != 0) {
+    base::DeleteFile(journal_path, false);
+    return 0;
+  }
+
+  size_t start = header.size();
+  for (size_t end = journal.find('\n', start); end != std::string::npos;
+       start = end + 1, end = journal.find('\n', start)) {
+    scoped_ptr<base::Value> record(base::JSONReader::Read(
+        base::StringPiece(journal.data() + start, end - start)));
+    base::DictionaryValue* dict = NULL;
+    std::string pref_path;
+    if (!record || !record->GetAsDictionary(&dict) ||
+        !dict->GetStringWithoutPathExpansion(kJournalPathKey, &pref_path)) {
+      break;
+    }
+    scoped_ptr<base::Value> value;
+    if (dict->RemoveWithoutPathExpansion(kJournalValueKey, &value))
+      prefs->Set(pref_path, value.release());
+    else
+      prefs->RemovePath(pref_path, NULL);
+  }
+
+  if (start != journal.size()) {
+    // Make sure new records start on a line of their own.
+    journal.resize(start);
+    base::ImportantFileWriter::WriteFileAtomically(journal_path, journal);
+  }
+  return start;
+}
+
+// Appends |records| to the journal of the preferences file at |path|,
+// starting the journal with a header for the file if there is none.
+void AppendToJournalFile(const base::FilePath& path,
+                         const std::string& records) {
+  base::FilePath journal_path = GetJournalPath(path);
+  bool exists = base::PathExists(journal_path);
+  std::string data = records;
+  if (!exists) {
+    std::string contents;
+    if (!base::ReadFileToString(path, &contents)) {
+      DLOG(WARNING) << "Failed to read " << path.value();
+      return;
+    }
+    data = GetJournalHeader(contents) + records;
+  }
+
+  int size = static_cast<int>(data.size());
+  int written = exists ?
+      file_util::AppendToFile(journal_path, data.data(), size) :
+      file_util::WriteFile(journal_path, data.data(), size);
+  if (written != size)
+    DLOG(WARNING) << "Failed to append to " << journal_path.value();
+}
+
+void ReplaceFileAndDeleteJournal(const base::FilePath& path,
+                                 const std::string& data) {
+  if (base::ImportantFileWriter::WriteFileAtomically(path, data))
+    base::DeleteFile(GetJournalPath(path), false);
+}
 
 // Differentiates file loading between origin thread and passed
 // (aka file) thread.
@@ -32,6 +152,8 @@ class FileThreadDeserializer
                          base::SequencedTaskRunner* sequenced_task_runner)
       : no_dir_(false),
         error_(PersistentPrefStore::PREF_READ_ERROR_NONE),
+        file_size_(0),
+        journal_size_(0),
         delegate_(delegate),
         sequenced_task_runner_(sequenced_task_runner),
         origin_loop_proxy_(base::MessageLoopProxy::current()) {
@@ -49,7 +171,8 @@ class FileThreadDeserializer
   void ReadFileAndReport(const base::FilePath& path) {
     DCHECK(sequenced_task_runner_->RunsTasksOnCurrentThread());
 
-    value_.reset(DoReading(path, &error_, &no_dir_));
+    value_.reset(
+        DoReading(path, &error_, &no_dir_, &file_size_, &journal_size_));
 
     origin_loop_proxy_->PostTask(
         FROM_HERE,
@@ -59,18 +182,39 @@ class FileThreadDeserializer
   // Reports deserialization result on the origin thread.
   void ReportOnOriginThread() {
     DCHECK(origin_loop_proxy_->BelongsToCurrentThread());
-    delegate_->OnFileRead(value_.release(), error_, no_dir_);
+    delegate_->OnFileRead(
+        value_.release(), error_, no_dir_, file_size_, journal_size_);
   }
 
   static base::Value* DoReading(const base::FilePath& path,
                                 PersistentPrefStore::PrefReadError* error,
-                                bool* no_dir) {
+                                bool* no_dir,
+                                int64* file_size,
+                                int64* journal_size) {
     int error_code;
     std::string error_msg;
     JSONFileValueSerializer serializer(path);
     base::Value* value = serializer.Deserialize(&error_code, &error_msg);
     HandleErrors(value, path, error_code, error_msg, error);
     *no_dir = !base::PathExists(path.DirName());
+
+    *file_size = 0;
+    *journal_size = 0;
+    switch (*error) {
+      case PersistentPrefStore::PREF_READ_ERROR_NONE:
+        base::GetFileSize(path, file_size);
+        *journal_size = ReplayJournal(
+            path, static_cast<base::DictionaryValue*>(value));
+        break;
+      case PersistentPrefStore::PREF_READ_ERROR_NO_FILE:
+      case PersistentPrefStore::PREF_READ_ERROR_JSON_PARSE:
+      case PersistentPrefStore::PREF_READ_ERROR_JSON_REPEAT:
+        // The journal is useless without the file it was written against.
+        base::DeleteFile(GetJournalPath(path), false);
+        break;
+      default:
+        break;
+    }
     return value;
   }
 
@@ -86,6 +230,8 @@ class FileThreadDeserializer
 
   bool no_dir_;
   PersistentPrefStore::PrefReadError error_;
+  int64 file_size_;
+  int64 journal_size_;
   scoped_ptr<base::Value> value_;
   const scoped_refptr<JsonPrefStore> delegate_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
@@ -161,7 +307,10 @@ JsonPrefStore::JsonPrefStore(const base::FilePath& filename,
       writer_(filename, sequenced_task_runner),
       pref_filter_(pref_filter.Pass()),
       initialized_(false),
-      read_error_(PREF_READ_ERROR_OTHER) {}
+      read_error_(PREF_READ_ERROR_OTHER),
+      journal_enabled_(false),
+      file_size_(0),
+      journal_size_(0) {}
 
 bool JsonPrefStore::GetValue(const std::string& key,
                              const base::Value** result) const {
@@ -214,8 +363,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   prefs_->Get(key, &old_value);
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
-    if (!read_only_)
-      writer_.ScheduleWrite(this);
+    ScheduleWrite(key);
   }
 }
 
@@ -234,15 +382,17 @@ PersistentPrefStore::PrefReadError JsonPrefStore::GetReadError() const {
 
 PersistentPrefStore::PrefReadError JsonPrefStore::ReadPrefs() {
   if (path_.empty()) {
-    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false);
+    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false, 0, 0);
     return PREF_READ_ERROR_FILE_NOT_SPECIFIED;
   }
 
   PrefReadError error;
   bool no_dir;
-  base::Value* value =
-      FileThreadDeserializer::DoReading(path_, &error, &no_dir);
-  OnFileRead(value, error, no_dir);
+  int64 file_size;
+  int64 journal_size;
+  base::Value* value = FileThreadDeserializer::DoReading(
+      path_, &error, &no_dir, &file_size, &journal_size);
+  OnFileRead(value, error, no_dir, file_size, journal_size);
   return error;
 }
 
@@ -250,7 +400,7 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
   initialized_ = false;
   error_delegate_.reset(error_delegate);
   if (path_.empty()) {
-    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false);
+    OnFileRead(NULL, PREF_READ_ERROR_FILE_NOT_SPECIFIED, false, 0, 0);
     return;
   }
 
@@ -262,7 +412,13 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
 }
 
 void JsonPrefStore::CommitPendingWrite() {
-  if (writer_.HasPendingWrite() && !read_only_)
+  if (read_only_)
+    return;
+
+  // Leave a file that does not need the journal, e.g. for older versions.
+  if (journal_timer_.IsRunning() || journal_size_ > 0)
+    WriteFileAndDeleteJournal();
+  else if (writer_.HasPendingWrite())
     writer_.DoScheduledWrite();
 }
 
@@ -272,15 +428,23 @@ void JsonPrefStore::ReportValueChanged(const std::string& key) {
 
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
 
-  if (!read_only_)
-    writer_.ScheduleWrite(this);
+  ScheduleWrite(key);
+}
+
+void JsonPrefStore::EnableJournal() {
+  DCHECK(!initialized_);
+  journal_enabled_ = true;
 }
 
 void JsonPrefStore::OnFileRead(base::Value* value_owned,
                                PersistentPrefStore::PrefReadError error,
-                               bool no_dir) {
+                               bool no_dir,
+                               int64 file_size,
+                               int64 journal_size) {
   scoped_ptr<base::Value> value(value_owned);
   read_error_ = error;
+  file_size_ = file_size;
+  journal_size_ = journal_size;
 
   if (no_dir) {
     FOR_EACH_OBSERVER(PrefStore::Observer,
@@ -317,6 +481,11 @@ void JsonPrefStore::OnFileRead(base::Value* value_owned,
   if (pref_filter_)
     pref_filter_->FilterOnLoad(prefs_.get());
 
+  // A journal left behind while journaling is disabled must be folded in
+  // before the file is written without it.
+  if (journal_size_ > 0 && !journal_enabled_ && !read_only_)
+    WriteFileAndDeleteJournal();
+
   if (error_delegate_.get() && error != PREF_READ_ERROR_NONE)
     error_delegate_->OnError(error);
 
@@ -335,5 +504,90 @@ bool JsonPrefStore::SerializeData(std::string* output) {
 
   JSONStringValueSerializer serializer(output);
   serializer.set_pretty_print(true);
-  return serializer.Serialize(*prefs_);
+  if (!serializer.Serialize(*prefs_))
+    return false;
+  UMA_HISTOGRAM_COUNTS("Settings.JsonPrefStore.FileBytesWritten",
+                       static_cast<int>(output->size()));
+  return true;
+}
+
+void JsonPrefStore::ScheduleWrite(const std::string& key) {
+  if (read_only_)
+    return;
+
+  if (!journal_enabled_) {
+    writer_.ScheduleWrite(this);
+    return;
+  }
+
+  journal_keys_.insert(key);
+  if (!journal_timer_.IsRunning()) {
+    journal_timer_.Start(FROM_HERE, writer_.commit_interval(),
+                         this, &JsonPrefStore::WriteJournal);
+  }
+}
+
+void JsonPrefStore::WriteJournal() {
+  // Without a file to apply it to, the journal would be lost on load.
+  if (file_size_ == 0) {
+    WriteFileAndDeleteJournal();
+    return;
+  }
+
+  AppendJournalRecords();
+  if (journal_size_ > std::max(file_size_, kMinJournalSizeToRewrite))
+    WriteFileAndDeleteJournal();
+}
+
+void JsonPrefStore::AppendJournalRecords() {
+  journal_timer_.Stop();
+  if (journal_keys_.empty())
+    return;
+
+  if (pref_filter_)
+    pref_filter_->FilterSerializeData(prefs_.get());
+
+  std::string records;
+  for (std::set<std::string>::const_iterator it = journal_keys_.begin();
+       it != journal_keys_.end(); ++it) {
+    base::DictionaryValue record;
+    record.SetStringWithoutPathExpansion(kJournalPathKey, *it);
+    const base::Value* value = NULL;
+    if (prefs_->Get(*it, &value))
+      record.SetWithoutPathExpansion(kJournalValueKey, value->DeepCopy());
+
+    std::string line;
+    JSONStringValueSerializer serializer(&line);
+    if (!serializer.Serialize(record))
+      continue;
+    records.append(line);
+    records.push_back('\n');
+  }
+  journal_keys_.clear();
+
+  journal_size_ += records.size();
+  UMA_HISTOGRAM_COUNTS("Settings.JsonPrefStore.JournalBytesWritten",
+                       static_cast<int>(records.size()));
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&AppendToJournalFile, path_, records));
+}
+
+void JsonPrefStore::WriteFileAndDeleteJournal() {
+  // Bring the journal up to date first, see the comment at the top.
+  if (journal_size_ > 0) {
+    AppendJournalRecords();
+  } else {
+    journal_timer_.Stop();
+    journal_keys_.clear();
+  }
+
+  std::string data;
+  if (!SerializeData(&data))
+    return;
+
+  file_size_ = data.size();
+  journal_size_ = 0;
+  sequenced_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&ReplaceFileAndDeleteJournal, path_, data));
 }
@@ -17,6 +17,7 @@
 #include "base/observer_list.h"
 #include "base/prefs/base_prefs_export.h"
 #include "base/prefs/persistent_pref_store.h"
+#include "base/timer/timer.h"
 
 class PrefFilter;
 
@@ -68,11 +69,26 @@ class BASE_PREFS_EXPORT JsonPrefStore
   virtual void CommitPendingWrite() OVERRIDE;
   virtual void ReportValueChanged(const std::string& key) OVERRIDE;
 
+  // Makes routine writes append the changed values to a journal next to the
+  // preferences file instead of rewriting the whole file. The journal is
+  // folded back into the file when it grows as large as the file, and by
+  // CommitPendingWrite(). Must be called before the prefs are read.
+  void EnableJournal();
+
+  // Sets how long changes are batched before they are written out.
+  void set_commit_interval_for_testing(const base::TimeDelta& interval) {
+    writer_.set_commit_interval(interval);
+  }
+
   // This method is called after JSON file has been read. Method takes
   // ownership of the |value| pointer. Note, this method is used with
   // asynchronous file reading, so class exposes it only for the internal needs.
   // (read: do not call it manually).
-  void OnFileRead(base::Value* value_owned, PrefReadError error, bool no_dir);
+  void OnFileRead(base::Value* value_owned,
+                  PrefReadError error,
+                  bool no_dir,
+                  int64 file_size,
+                  int64 journal_size);
 
  private:
   virtual ~JsonPrefStore();
@@ -80,6 +96,17 @@ class BASE_PREFS_EXPORT JsonPrefStore
   // ImportantFileWriter::DataSerializer overrides:
   virtual bool SerializeData(std::string* output) OVERRIDE;
 
+  // Schedules |key| to be written out, to the journal if it is enabled.
+  void ScheduleWrite(const std::string& key);
+
+  // Appends the current values of |journal_keys_| to the journal, then
+  // writes the whole file if the journal has grown too large.
+  void WriteJournal();
+  void AppendJournalRecords();
+
+  // Writes the whole file, then deletes the journal.
+  void WriteFileAndDeleteJournal();
+
   base::FilePath path_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
 
@@ -100,6 +127,14 @@ class BASE_PREFS_EXPORT JsonPrefStore
 
   std::set<std::string> keys_need_empty_value_;
 
+  bool journal_enabled_;
+  // Keys changed since the journal was last written.
+  std::set<std::string> journal_keys_;
+  base::OneShotTimer<JsonPrefStore> journal_timer_;
+  // Sizes of the preferences file and the journal as last written.
+  int64 file_size_;
+  int64 journal_size_;
+
   DISALLOW_COPY_AND_ASSIGN(JsonPrefStore);
 };
 
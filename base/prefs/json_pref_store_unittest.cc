@@ -6,6 +6,7 @@
 
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/md5.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
@@ -25,6 +26,11 @@ namespace {
 
 const char kHomePage[] = "homepage";
 
+// Returns the header of a journal started against a file holding |prefs|.
+std::string GetJournalHeader(const std::string& prefs) {
+  return "{\"base_md5\":\"" + MD5String(prefs) + "\"}\n";
+}
+
 class MockPrefStoreObserver : public PrefStore::Observer {
  public:
   MOCK_METHOD1(OnPrefValueChanged, void (const std::string&));
@@ -301,4 +307,192 @@ TEST_F(JsonPrefStoreTest, AsyncNonExistingFile) {
   EXPECT_FALSE(pref_store->ReadOnly());
 }
 
+// Tests that changes in the journal are applied on load, up to a torn
+// record, and folded into the file by CommitPendingWrite().
+TEST_F(JsonPrefStoreTest, Journal) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("journal.json");
+  FilePath journal_file = pref_file.AddExtension(FILE_PATH_LITERAL("journal"));
+  const std::string kPrefs = "{\"homepage\": \"http://www.cnn.com\"}";
+  const std::string kJournal = GetJournalHeader(kPrefs) +
+      "{\"path\":\"homepage\",\"value\":\"http://www.example.com\"}\n"
+      "{\"path\":\"some_directory\",\"value\":\"/usr/local/\"}\n"
+      "{\"path\":\"some_directory\"}\n"
+      "{\"path\":\"torn\",\"val";
+  ASSERT_EQ(static_cast<int>(kPrefs.size()),
+            file_util::WriteFile(pref_file, kPrefs.data(), kPrefs.size()));
+  ASSERT_EQ(static_cast<int>(kJournal.size()),
+            file_util::WriteFile(journal_file, kJournal.data(),
+                                 kJournal.size()));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  pref_store->EnableJournal();
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+
+  const Value* actual;
+  std::string string_value;
+  EXPECT_TRUE(pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.example.com", string_value);
+  EXPECT_FALSE(pref_store->GetValue("some_directory", &actual));
+  EXPECT_FALSE(pref_store->GetValue("torn", &actual));
+
+  pref_store->CommitPendingWrite();
+  RunLoop().RunUntilIdle();
+  EXPECT_FALSE(PathExists(journal_file));
+
+  pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+  EXPECT_TRUE(pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.example.com", string_value);
+}
+
+// Tests that a journal started against another version of the file is
+// ignored and deleted on load.
+TEST_F(JsonPrefStoreTest, JournalForOtherFile) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("journal.json");
+  FilePath journal_file = pref_file.AddExtension(FILE_PATH_LITERAL("journal"));
+  const std::string kPrefs = "{\"homepage\": \"http://www.cnn.com\"}";
+  const std::string kJournal =
+      GetJournalHeader("{\"homepage\": \"http://www.google.com\"}") +
+      "{\"path\":\"homepage\",\"value\":\"http://www.example.com\"}\n";
+  ASSERT_EQ(static_cast<int>(kPrefs.size()),
+            file_util::WriteFile(pref_file, kPrefs.data(), kPrefs.size()));
+  ASSERT_EQ(static_cast<int>(kJournal.size()),
+            file_util::WriteFile(journal_file, kJournal.data(),
+                                 kJournal.size()));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  pref_store->EnableJournal();
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+
+  const Value* actual;
+  std::string string_value;
+  EXPECT_TRUE(pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.cnn.com", string_value);
+  EXPECT_FALSE(PathExists(journal_file));
+}
+
+// Tests that a change is appended to the journal, leaving the file alone.
+TEST_F(JsonPrefStoreTest, JournalWrite) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("journal.json");
+  FilePath journal_file = pref_file.AddExtension(FILE_PATH_LITERAL("journal"));
+  const std::string kPrefs = "{\"homepage\": \"http://www.cnn.com\"}";
+  ASSERT_EQ(static_cast<int>(kPrefs.size()),
+            file_util::WriteFile(pref_file, kPrefs.data(), kPrefs.size()));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  pref_store->EnableJournal();
+  pref_store->set_commit_interval_for_testing(TimeDelta());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+
+  pref_store->SetValue(kHomePage, new StringValue("http://www.example.com"));
+  RunLoop().RunUntilIdle();
+
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(journal_file, &contents));
+  EXPECT_EQ(GetJournalHeader(kPrefs) +
+            "{\"path\":\"homepage\",\"value\":\"http://www.example.com\"}\n",
+            contents);
+  ASSERT_TRUE(ReadFileToString(pref_file, &contents));
+  EXPECT_EQ(kPrefs, contents);
+}
+
+// Tests that the file is rewritten and the journal deleted once the journal
+// grows too large.
+TEST_F(JsonPrefStoreTest, JournalRewritesLargeJournal) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("journal.json");
+  FilePath journal_file = pref_file.AddExtension(FILE_PATH_LITERAL("journal"));
+  const std::string kPrefs = "{\"homepage\": \"http://www.cnn.com\"}";
+  ASSERT_EQ(static_cast<int>(kPrefs.size()),
+            file_util::WriteFile(pref_file, kPrefs.data(), kPrefs.size()));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  pref_store->EnableJournal();
+  pref_store->set_commit_interval_for_testing(TimeDelta());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+
+  // A record larger than both the file and the minimum journal size.
+  const std::string kLargeValue(100 * 1024, 'x');
+  pref_store->SetValue("large", new StringValue(kLargeValue));
+  RunLoop().RunUntilIdle();
+
+  EXPECT_FALSE(PathExists(journal_file));
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(pref_file, &contents));
+  EXPECT_NE(std::string::npos, contents.find(kLargeValue));
+
+  pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+  const Value* actual;
+  std::string string_value;
+  EXPECT_TRUE(pref_store->GetValue("large", &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ(kLargeValue, string_value);
+}
+
+// Tests that a store reloads a journal it wrote on top of its file.
+TEST_F(JsonPrefStoreTest, JournalReload) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("journal.json");
+  FilePath journal_file = pref_file.AddExtension(FILE_PATH_LITERAL("journal"));
+  const std::string kPrefs = "{\"homepage\": \"http://www.cnn.com\", "
+                             "\"some_directory\": \"/usr/local/\"}";
+  ASSERT_EQ(static_cast<int>(kPrefs.size()),
+            file_util::WriteFile(pref_file, kPrefs.data(), kPrefs.size()));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  pref_store->EnableJournal();
+  pref_store->set_commit_interval_for_testing(TimeDelta());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+  pref_store->SetValue(kHomePage, new StringValue("http://www.example.com"));
+  pref_store->RemoveValue("some_directory");
+  RunLoop().RunUntilIdle();
+  ASSERT_TRUE(PathExists(journal_file));
+
+  // Read the files while |pref_store| is alive, as releasing it commits the
+  // journal to the file.
+  scoped_refptr<JsonPrefStore> reloaded_pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy().get(),
+      scoped_ptr<PrefFilter>());
+  reloaded_pref_store->EnableJournal();
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            reloaded_pref_store->ReadPrefs());
+  const Value* actual;
+  std::string string_value;
+  EXPECT_TRUE(reloaded_pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.example.com", string_value);
+  EXPECT_FALSE(reloaded_pref_store->GetValue("some_directory", &actual));
+}
+
 }  // namespace base
@@ -91,6 +91,7 @@ LayerImpl::~LayerImpl() {
   if (!copy_requests_.empty() && layer_tree_impl_->IsActiveTree())
     layer_tree_impl()->RemoveLayerWithCopyOutputRequest(this);
   layer_tree_impl_->UnregisterLayer(this);
+  layer_tree_impl_->set_needs_update_meta_information();
 
   if (scroll_children_) {
     for (std::set<LayerImpl*>::iterator it = scroll_children_->begin();
@@ -120,6 +121,7 @@ void LayerImpl::AddChild(scoped_ptr<LayerImpl> child) {
   DCHECK_EQ(layer_tree_impl(), child->layer_tree_impl());
   children_.push_back(child.Pass());
   layer_tree_impl()->set_needs_update_draw_properties();
+  layer_tree_impl()->set_needs_update_meta_information();
 }
 
 scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
@@ -130,6 +132,7 @@ scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
       scoped_ptr<LayerImpl> ret = children_.take(it);
       children_.erase(it);
       layer_tree_impl()->set_needs_update_draw_properties();
+      layer_tree_impl()->set_needs_update_meta_information();
       return ret.Pass();
     }
   }
@@ -152,6 +155,7 @@ void LayerImpl::ClearChildList() {
 
   children_.clear();
   layer_tree_impl()->set_needs_update_draw_properties();
+  layer_tree_impl()->set_needs_update_meta_information();
 }
 
 bool LayerImpl::HasAncestor(const LayerImpl* ancestor) const {
@@ -177,6 +181,7 @@ void LayerImpl::SetScrollParent(LayerImpl* parent) {
     scroll_parent_->RemoveScrollChild(this);
 
   scroll_parent_ = parent;
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -209,6 +214,7 @@ void LayerImpl::SetClipParent(LayerImpl* ancestor) {
     clip_parent_->RemoveClipChild(this);
 
   clip_parent_ = ancestor;
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -216,6 +222,7 @@ void LayerImpl::SetClipChildren(std::set<LayerImpl*>* children) {
   if (clip_children_.get() == children)
     return;
   clip_children_.reset(children);
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -224,6 +231,7 @@ void LayerImpl::RemoveClipChild(LayerImpl* child) {
   clip_children_->erase(child);
   if (clip_children_->empty())
     clip_children_.reset();
+  layer_tree_impl()->set_needs_update_meta_information();
   SetNeedsPushProperties();
 }
 
@@ -237,6 +245,7 @@ void LayerImpl::PassCopyRequests(ScopedPtrVector<CopyOutputRequest>* requests) {
 
   if (was_empty && layer_tree_impl()->IsActiveTree())
     layer_tree_impl()->AddLayerWithCopyOutputRequest(this);
+  layer_tree_impl()->set_needs_update_meta_information();
   NoteLayerPropertyChangedForSubtree();
 }
 
@@ -248,6 +257,7 @@ void LayerImpl::TakeCopyRequestsAndTransformToTarget(
   size_t first_inserted_request = requests->size();
   requests->insert_and_take(requests->end(), copy_requests_);
   copy_requests_.clear();
+  layer_tree_impl()->set_needs_update_meta_information();
 
   for (size_t i = first_inserted_request; i < requests->size(); ++i) {
     CopyOutputRequest* request = requests->at(i);
@@ -824,6 +834,7 @@ void LayerImpl::SetDrawsContent(bool draws_content) {
     return;
 
   draws_content_ = draws_content;
+  layer_tree_impl()->set_needs_update_meta_information();
   NoteLayerPropertyChanged();
 }
 
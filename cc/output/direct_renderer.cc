@@ -420,6 +420,12 @@ bool DirectRenderer::UseRenderPass(DrawingFrame* frame,
 
 void DirectRenderer::RunOnDemandRasterTask(
     internal::Task* on_demand_raster_task) {
+  RunOnDemandRasterTasks(
+      internal::Task::Vector(1, make_scoped_refptr(on_demand_raster_task)));
+}
+
+void DirectRenderer::RunOnDemandRasterTasks(
+    const internal::Task::Vector& on_demand_raster_tasks) {
   internal::TaskGraphRunner* task_graph_runner =
       RasterWorkerPool::GetTaskGraphRunner();
   DCHECK(task_graph_runner);
@@ -428,23 +434,27 @@ void DirectRenderer::RunOnDemandRasterTask(
   if (!on_demand_task_namespace_.IsValid())
     on_demand_task_namespace_ = task_graph_runner->GetNamespaceToken();
 
-  // Construct a task graph that contains this single raster task.
+  // Construct a task graph that contains these independent raster tasks.
   internal::TaskGraph graph;
-  graph.nodes.push_back(
-      internal::TaskGraph::Node(on_demand_raster_task,
-                                RasterWorkerPool::kOnDemandRasterTaskPriority,
-                                0u));
+  for (internal::Task::Vector::const_iterator it =
+           on_demand_raster_tasks.begin();
+       it != on_demand_raster_tasks.end();
+       ++it) {
+    graph.nodes.push_back(
+        internal::TaskGraph::Node(it->get(),
+                                  RasterWorkerPool::kOnDemandRasterTaskPriority,
+                                  0u));
+  }
 
-  // Schedule task and wait for task graph runner to finish running it.
+  // Schedule tasks and wait for task graph runner to finish running them.
   task_graph_runner->SetTaskGraph(on_demand_task_namespace_, &graph);
   task_graph_runner->WaitForTasksToFinishRunning(on_demand_task_namespace_);
 
-  // Collect task now that it has finished running.
+  // Collect tasks now that they have finished running.
   internal::Task::Vector completed_tasks;
   task_graph_runner->CollectCompletedTasks(on_demand_task_namespace_,
                                            &completed_tasks);
-  DCHECK_EQ(1u, completed_tasks.size());
-  DCHECK_EQ(completed_tasks[0], on_demand_raster_task);
+  DCHECK_EQ(on_demand_raster_tasks.size(), completed_tasks.size());
 }
 
 bool DirectRenderer::HasAllocatedResourcesForTesting(RenderPass::Id id)
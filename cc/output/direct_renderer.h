@@ -98,6 +98,10 @@ class CC_EXPORT DirectRenderer : public Renderer {
   bool UseRenderPass(DrawingFrame* frame, const RenderPass* render_pass);
 
   void RunOnDemandRasterTask(internal::Task* on_demand_raster_task);
+  // Runs |on_demand_raster_tasks| concurrently on the raster threads and
+  // returns once all of them have finished.
+  void RunOnDemandRasterTasks(
+      const internal::Task::Vector& on_demand_raster_tasks);
 
   virtual void BindFramebufferToOutputSurface(DrawingFrame* frame) = 0;
   virtual bool BindFramebufferToTexture(DrawingFrame* frame,
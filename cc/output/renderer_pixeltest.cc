@@ -1768,6 +1768,82 @@ TYPED_TEST(RendererPixelTest, PictureDrawQuadOpacity) {
       FuzzyPixelOffByOneComparator(true)));
 }
 
+scoped_ptr<RenderPass> CreatePictureBandsTestPass(const gfx::Rect& viewport,
+                                                  PicturePileImpl* pile,
+                                                  const gfx::Rect& quad_rect,
+                                                  const gfx::Rect& clip_rect) {
+  RenderPass::Id id(1, 1);
+  gfx::Transform transform_to_root;
+  scoped_ptr<RenderPass> pass =
+      CreateTestRenderPass(id, viewport, transform_to_root);
+
+  gfx::Transform content_to_target_transform;
+  content_to_target_transform.Translate(quad_rect.x(), quad_rect.y());
+  gfx::Rect content_rect(quad_rect.size());
+  scoped_ptr<SharedQuadState> shared_state = CreateTestSharedQuadStateClipped(
+      content_to_target_transform, content_rect, clip_rect);
+
+  scoped_ptr<PictureDrawQuad> quad = PictureDrawQuad::Create();
+  quad->SetNew(shared_state.get(),
+               content_rect,
+               gfx::Rect(),
+               content_rect,
+               content_rect.size(),
+               RGBA_8888,
+               content_rect,
+               1.f,
+               pile);
+  pass->quad_list.push_back(quad.PassAs<DrawQuad>());
+  pass->shared_quad_state_list.push_back(shared_state.Pass());
+  return pass.Pass();
+}
+
+// A picture quad rasterized in bands must match the same quad rasterized in
+// one piece, including rows next to band boundaries and bands that are
+// entirely clipped out.
+TEST_F(SoftwareRendererPixelTest, PictureDrawQuadBandsMatchUnbanded) {
+  // Tall enough for three bands of at least kMinPictureQuadBandHeight rows.
+  device_viewport_size_ = gfx::Size(200, 420);
+  gfx::Rect viewport(device_viewport_size_);
+  gfx::Rect quad_rect(0, 20, 200, 400);
+  gfx::Rect clip_rect(10, 170, 180, 240);
+
+  // Stripes that straddle the band boundaries.
+  scoped_refptr<FakePicturePileImpl> fake_pile =
+      FakePicturePileImpl::CreateFilledPile(gfx::Size(1000, 1000),
+                                            quad_rect.size());
+  const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+  for (int y = 0; y < quad_rect.height(); y += 30) {
+    SkPaint paint;
+    paint.setColor(colors[(y / 30) % arraysize(colors)]);
+    fake_pile->add_draw_rect_with_paint(
+        gfx::Rect(y % 50, y, quad_rect.width() - y % 50, 30), paint);
+  }
+  fake_pile->RerecordPile();
+
+  // Bands are only used with a pile that has a clone per raster thread.
+  scoped_refptr<PicturePileImpl> pile =
+      PicturePileImpl::CreateFromOther(fake_pile.get());
+  ASSERT_GE(pile->GetNumClonesForDrawing(), 1u);
+
+  renderer()->set_max_picture_quad_bands_for_testing(1);
+  RenderPassList pass_list;
+  pass_list.push_back(
+      CreatePictureBandsTestPass(viewport, pile.get(), quad_rect, clip_rect));
+  DrawAndReadback(&pass_list, pass_list.back(), NoOffscreenContext);
+  ASSERT_TRUE(result_bitmap_);
+  scoped_ptr<SkBitmap> unbanded_bitmap = result_bitmap_.Pass();
+
+  renderer()->set_max_picture_quad_bands_for_testing(3);
+  pass_list.push_back(
+      CreatePictureBandsTestPass(viewport, pile.get(), quad_rect, clip_rect));
+  DrawAndReadback(&pass_list, pass_list.back(), NoOffscreenContext);
+  ASSERT_TRUE(result_bitmap_);
+
+  EXPECT_TRUE(
+      ExactPixelComparator(true).Compare(*result_bitmap_, *unbanded_bitmap));
+}
+
 template<typename TypeParam> bool IsSoftwareRenderer() {
   return false;
 }
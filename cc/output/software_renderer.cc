@@ -4,6 +4,8 @@
 
 #include "cc/output/software_renderer.h"
 
+#include <algorithm>
+
 #include "base/debug/trace_event.h"
 #include "cc/base/math_util.h"
 #include "cc/output/compositor_frame.h"
@@ -20,7 +22,9 @@
 #include "cc/quads/solid_color_draw_quad.h"
 #include "cc/quads/texture_draw_quad.h"
 #include "cc/quads/tile_draw_quad.h"
+#include "cc/resources/raster_worker_pool.h"
 #include "skia/ext/opacity_draw_filter.h"
+#include "third_party/skia/include/core/SkBitmapDevice.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
@@ -67,6 +71,45 @@ class OnDemandRasterTaskImpl : public internal::Task {
   DISALLOW_COPY_AND_ASSIGN(OnDemandRasterTaskImpl);
 };
 
+// Rasterizes one horizontal band of a picture quad. Bands of the same quad
+// run concurrently, so each draws through its own canvas and device and with
+// the picture pile clone of the thread it runs on.
+class OnDemandRasterBandTaskImpl : public internal::Task {
+ public:
+  OnDemandRasterBandTaskImpl(PicturePileImpl* picture_pile,
+                             skia::RefPtr<SkCanvas> canvas,
+                             gfx::Rect content_rect,
+                             float contents_scale)
+      : picture_pile_(picture_pile),
+        canvas_(canvas),
+        content_rect_(content_rect),
+        contents_scale_(contents_scale) {
+    DCHECK(picture_pile_);
+    DCHECK(canvas_);
+  }
+
+  // Overridden from internal::Task:
+  virtual void RunOnWorkerThread(unsigned thread_index) OVERRIDE {
+    TRACE_EVENT0("cc", "OnDemandRasterBandTaskImpl::RunOnWorkerThread");
+    picture_pile_->GetCloneForDrawingOnThread(thread_index)->RasterDirect(
+        canvas_.get(), content_rect_, contents_scale_, NULL);
+  }
+
+ protected:
+  virtual ~OnDemandRasterBandTaskImpl() {}
+
+ private:
+  PicturePileImpl* picture_pile_;
+  skia::RefPtr<SkCanvas> canvas_;
+  const gfx::Rect content_rect_;
+  const float contents_scale_;
+
+  DISALLOW_COPY_AND_ASSIGN(OnDemandRasterBandTaskImpl);
+};
+
+// Picture quads are only split into bands at least this many rows tall.
+const int kMinPictureQuadBandHeight = 128;
+
 static inline bool IsScalarNearlyInteger(SkScalar scalar) {
   return SkScalarNearlyZero(scalar - SkScalarRoundToScalar(scalar));
 }
@@ -112,7 +155,8 @@ SoftwareRenderer::SoftwareRenderer(RendererClient* client,
       is_scissor_enabled_(false),
       is_backbuffer_discarded_(false),
       output_device_(output_surface->software_device()),
-      current_canvas_(NULL) {
+      current_canvas_(NULL),
+      max_picture_quad_bands_for_testing_(0) {
   if (resource_provider_) {
     capabilities_.max_texture_size = resource_provider_->max_texture_size();
     capabilities_.best_texture_format =
@@ -383,6 +427,81 @@ void SoftwareRenderer::DrawPictureQuad(const DrawingFrame* frame,
   TRACE_EVENT0("cc",
                "SoftwareRenderer::DrawPictureQuad");
 
+  // A quad drawn at an integer translation into a plain bitmap is
+  // rasterized in horizontal bands, one per raster thread. Each band draws
+  // through its own device over a disjoint slice of rows of the target
+  // bitmap, so bands running concurrently never share device state or
+  // pixels.
+  const SkMatrix& total_matrix = current_canvas_->getTotalMatrix();
+  const gfx::Rect& content_rect = quad->content_rect;
+  int num_raster_threads = RasterWorkerPool::GetNumRasterThreads();
+  int max_bands = max_picture_quad_bands_for_testing_
+                      ? max_picture_quad_bands_for_testing_
+                      : num_raster_threads;
+  int num_bands =
+      std::min(max_bands, content_rect.height() / kMinPictureQuadBandHeight);
+  SkBitmap target_bitmap;
+  if (num_bands > 1 &&
+      quad->picture_pile->GetNumClonesForDrawing() >=
+          static_cast<size_t>(num_raster_threads) &&
+      !(total_matrix.getType() & ~SkMatrix::kTranslate_Mask) &&
+      IsScaleAndIntegerTranslate(total_matrix) &&
+      current_canvas_->isClipRect()) {
+    bool will_change_pixels = true;
+    target_bitmap = current_canvas_->getDevice()->accessBitmap(
+        will_change_pixels);
+  }
+  if (target_bitmap.getPixels()) {
+    SkIRect clip_bounds;
+    if (!current_canvas_->getClipDeviceBounds(&clip_bounds))
+      clip_bounds.setEmpty();
+    int translate_y = SkScalarRoundToInt(total_matrix.getTranslateY());
+
+    internal::Task::Vector band_tasks;
+    for (int i = 0; i < num_bands; ++i) {
+      int top = content_rect.y() + content_rect.height() * i / num_bands;
+      int bottom =
+          content_rect.y() + content_rect.height() * (i + 1) / num_bands;
+
+      // The rows of the target this band covers, limited to the clip. The
+      // band's device only spans these rows, which stands in for the clip.
+      SkIRect band_device_rect =
+          SkIRect::MakeLTRB(clip_bounds.left(),
+                            translate_y + top - content_rect.y(),
+                            clip_bounds.right(),
+                            translate_y + bottom - content_rect.y());
+      SkBitmap band_bitmap;
+      if (!band_device_rect.intersect(clip_bounds) ||
+          !target_bitmap.extractSubset(&band_bitmap, band_device_rect))
+        continue;
+
+      // Drawing |band_rect| shifts the canvas by its origin, so shift the
+      // band's canvas back to where the whole quad would be drawn, relative
+      // to the band's device.
+      SkMatrix band_matrix = total_matrix;
+      band_matrix.postTranslate(SkIntToScalar(-band_device_rect.left()),
+                                SkIntToScalar(-band_device_rect.top()));
+      band_matrix.preTranslate(0, SkIntToScalar(top - content_rect.y()));
+
+      skia::RefPtr<SkBaseDevice> band_device =
+          skia::AdoptRef(new SkBitmapDevice(band_bitmap));
+      skia::RefPtr<SkCanvas> band_canvas =
+          skia::AdoptRef(new SkCanvas(band_device.get()));
+      band_canvas->setMatrix(band_matrix);
+      band_canvas->setDrawFilter(opacity_filter.get());
+
+      band_tasks.push_back(make_scoped_refptr(new OnDemandRasterBandTaskImpl(
+          quad->picture_pile,
+          band_canvas,
+          gfx::Rect(content_rect.x(), top, content_rect.width(), bottom - top),
+          quad->contents_scale)));
+    }
+    RunOnDemandRasterTasks(band_tasks);
+
+    current_canvas_->setDrawFilter(NULL);
+    return;
+  }
+
   // Create and run on-demand raster task for tile.
   scoped_refptr<internal::Task> on_demand_raster_task(
       new OnDemandRasterTaskImpl(quad->picture_pile,
@@ -49,6 +49,12 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   virtual void DiscardBackbuffer() OVERRIDE;
   virtual void EnsureBackbuffer() OVERRIDE;
 
+  // Splits picture quads into at most |max_bands| bands instead of one per
+  // raster thread. Zero restores the default.
+  void set_max_picture_quad_bands_for_testing(int max_bands) {
+    max_picture_quad_bands_for_testing_ = max_bands;
+  }
+
  protected:
   virtual void BindFramebufferToOutputSurface(DrawingFrame* frame) OVERRIDE;
   virtual bool BindFramebufferToTexture(
@@ -111,6 +117,7 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   scoped_ptr<ResourceProvider::ScopedWriteLockSoftware>
       current_framebuffer_lock_;
   scoped_ptr<SoftwareFrameData> current_frame_data_;
+  int max_picture_quad_bands_for_testing_;
 
   DISALLOW_COPY_AND_ASSIGN(SoftwareRenderer);
 };
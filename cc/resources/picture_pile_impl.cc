@@ -70,6 +70,10 @@ PicturePileImpl* PicturePileImpl::GetCloneForDrawingOnThread(
   return clones_for_drawing_.clones_[thread_index].get();
 }
 
+size_t PicturePileImpl::GetNumClonesForDrawing() const {
+  return clones_for_drawing_.clones_.size();
+}
+
 void PicturePileImpl::RasterDirect(
     SkCanvas* canvas,
     const gfx::Rect& canvas_rect,
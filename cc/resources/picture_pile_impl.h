@@ -29,6 +29,9 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
   // Get paint-safe version of this picture for a specific thread.
   PicturePileImpl* GetCloneForDrawingOnThread(unsigned thread_index) const;
 
+  // Number of threads GetCloneForDrawingOnThread() can be called for.
+  size_t GetNumClonesForDrawing() const;
+
   // Raster a subrect of this PicturePileImpl into the given canvas.
   // It's only safe to call paint on a cloned version.  It is assumed
   // that contents_scale has already been applied to this canvas.
@@ -11,30 +11,50 @@
 
 namespace cc {
 
+// The fields BinComparator orders tiles by, copied out of each Tile so that
+// sorting a bin compares contiguous keys rather than following two Tile
+// pointers into their ManagedTileStates for every comparison.
+struct TileSortKey {
+  TilePriority::PriorityBin priority_bin;
+  bool required_for_activation;
+  TileResolution resolution;
+  float distance_to_visible;
+  int y;
+  int x;
+  Tile* tile;
+};
+
 class BinComparator {
  public:
-  bool operator()(const Tile* a,
-                  const Tile* b) const {
-    const ManagedTileState& ams = a->managed_state();
-    const ManagedTileState& bms = b->managed_state();
+  static TileSortKey KeyForTile(Tile* tile) {
+    const ManagedTileState& mts = tile->managed_state();
+    TileSortKey key;
+    key.priority_bin = mts.priority_bin;
+    key.required_for_activation = mts.required_for_activation;
+    key.resolution = mts.resolution;
+    key.distance_to_visible = mts.distance_to_visible;
+    key.y = tile->content_rect().y();
+    key.x = tile->content_rect().x();
+    key.tile = tile;
+    return key;
+  }
 
-    if (ams.priority_bin != bms.priority_bin)
-      return ams.priority_bin < bms.priority_bin;
+  bool operator()(const TileSortKey& a, const TileSortKey& b) const {
+    if (a.priority_bin != b.priority_bin)
+      return a.priority_bin < b.priority_bin;
 
-    if (ams.required_for_activation != bms.required_for_activation)
-      return ams.required_for_activation;
+    if (a.required_for_activation != b.required_for_activation)
+      return a.required_for_activation;
 
-    if (ams.resolution != bms.resolution)
-      return ams.resolution < bms.resolution;
+    if (a.resolution != b.resolution)
+      return a.resolution < b.resolution;
 
-    if (ams.distance_to_visible != bms.distance_to_visible)
-      return ams.distance_to_visible < bms.distance_to_visible;
+    if (a.distance_to_visible != b.distance_to_visible)
+      return a.distance_to_visible < b.distance_to_visible;
 
-    gfx::Rect a_rect = a->content_rect();
-    gfx::Rect b_rect = b->content_rect();
-    if (a_rect.y() != b_rect.y())
-      return a_rect.y() < b_rect.y();
-    return a_rect.x() < b_rect.x();
+    if (a.y != b.y)
+      return a.y < b.y;
+    return a.x < b.x;
   }
 };
 
@@ -42,6 +62,18 @@ namespace {
 
 typedef std::vector<Tile*> TileVector;
 
+void SortTiles(TileVector* tiles) {
+  std::vector<TileSortKey> keys;
+  keys.reserve(tiles->size());
+  for (TileVector::const_iterator it = tiles->begin(); it != tiles->end(); ++it)
+    keys.push_back(BinComparator::KeyForTile(*it));
+
+  std::sort(keys.begin(), keys.end(), BinComparator());
+
+  for (size_t i = 0; i < keys.size(); ++i)
+    (*tiles)[i] = keys[i].tile;
+}
+
 void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
   switch (bin) {
     case NOW_AND_READY_TO_DRAW_BIN:
@@ -53,7 +85,7 @@ void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
     case EVENTUALLY_BIN:
     case AT_LAST_AND_ACTIVE_BIN:
     case AT_LAST_BIN:
-      std::sort(tiles->begin(), tiles->end(), BinComparator());
+      SortTiles(tiles);
       break;
     default:
       NOTREACHED();
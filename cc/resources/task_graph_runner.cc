@@ -5,6 +5,8 @@
 #include "cc/resources/task_graph_runner.h"
 
 #include <algorithm>
+#include <functional>
+#include <utility>
 
 #include "base/debug/trace_event.h"
 #include "base/strings/stringprintf.h"
@@ -14,11 +16,71 @@ namespace cc {
 namespace internal {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
+// Index of the nodes of a task graph, sorted by task. Each entry holds the
+// position of the task's node in TaskGraph::nodes.
+typedef std::vector<std::pair<const Task*, size_t> > NodeIndex;
+
+bool CompareNodeIndexEntries(const NodeIndex::value_type& a,
+                             const NodeIndex::value_type& b) {
+  return std::less<const Task*>()(a.first, b.first);
+}
+
+bool NodeIndexEntryIsBefore(const NodeIndex::value_type& entry,
+                            const Task* task) {
+  return std::less<const Task*>()(entry.first, task);
+}
+
+bool CompareEdgesByTask(const TaskGraph::Edge& a, const TaskGraph::Edge& b) {
+  return std::less<const Task*>()(a.task, b.task);
+}
+
+bool EdgeIsBefore(const TaskGraph::Edge& edge, const Task* task) {
+  return std::less<const Task*>()(edge.task, task);
+}
+
+// Sorts the edges of |graph| by task, so that the edges of each task are
+// adjacent, and builds the index of its nodes in |node_index|.
+void IndexTaskGraph(TaskGraph* graph, NodeIndex* node_index) {
+  std::sort(graph->edges.begin(), graph->edges.end(), CompareEdgesByTask);
+
+  node_index->clear();
+  node_index->reserve(graph->nodes.size());
+  for (size_t i = 0; i < graph->nodes.size(); ++i)
+    node_index->push_back(std::make_pair(graph->nodes[i].task, i));
+  std::sort(node_index->begin(), node_index->end(), CompareNodeIndexEntries);
+}
+
+// Returns the node for |task| in |graph|, or NULL if |task| is not part of
+// |graph|. |node_index| must have been built by IndexTaskGraph().
+TaskGraph::Node* FindNode(TaskGraph* graph,
+                          const NodeIndex& node_index,
+                          const Task* task) {
+  NodeIndex::const_iterator it = std::lower_bound(
+      node_index.begin(), node_index.end(), task, NodeIndexEntryIsBefore);
+  if (it == node_index.end() || it->first != task)
+    return NULL;
+  return &graph->nodes[it->second];
+}
+
+// Helper class for iterating over all dependents of a task. The graph must
+// have been indexed by IndexTaskGraph().
 class DependentIterator {
  public:
-  DependentIterator(TaskGraph* graph, const Task* task)
-      : graph_(graph), task_(task), current_index_(-1), current_node_(NULL) {
+  DependentIterator(TaskGraph* graph,
+                    const NodeIndex* node_index,
+                    const Task* task)
+      : graph_(graph),
+        node_index_(node_index),
+        task_(task),
+        current_index_(-1),
+        current_node_(NULL) {
+    // Start just before the first edge of |task_|; wraps around if that is
+    // the first edge of the graph.
+    current_index_ += std::lower_bound(graph_->edges.begin(),
+                                       graph_->edges.end(),
+                                       task_,
+                                       EdgeIsBefore) -
+                      graph_->edges.begin();
     ++(*this);
   }
 
@@ -36,23 +98,21 @@ class DependentIterator {
     return *current_node_;
   }
 
-  // Note: Performance can be improved by keeping edges sorted.
   DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
+    // Edges are sorted by task, so the next dependency edge for |task_|, if
+    // any, is the next edge.
+    ++current_index_;
+    if (current_index_ == graph_->edges.size())
+      return *this;
+    if (graph_->edges[current_index_].task != task_) {
+      current_index_ = graph_->edges.size();
+      return *this;
+    }
 
     // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
+    current_node_ = FindNode(
+        graph_, *node_index_, graph_->edges[current_index_].dependent);
+    DCHECK(current_node_);
 
     return *this;
   }
@@ -61,6 +121,7 @@ class DependentIterator {
 
  private:
   TaskGraph* graph_;
+  const NodeIndex* node_index_;
   const Task* task_;
   size_t current_index_;
   TaskGraph::Node* current_node_;
@@ -230,36 +291,30 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
 
     TaskNamespace& task_namespace = namespaces_[token.id_];
 
+    // Index the new graph so that dependents and old tasks can be looked up
+    // without scanning it.
+    NodeIndex node_index;
+    IndexTaskGraph(graph, &node_index);
+
     // First adjust number of dependencies to reflect completed tasks.
     for (Task::Vector::iterator it = task_namespace.completed_tasks.begin();
          it != task_namespace.completed_tasks.end();
          ++it) {
-      for (DependentIterator node_it(graph, it->get()); node_it; ++node_it) {
+      for (DependentIterator node_it(graph, &node_index, it->get()); node_it;
+           ++node_it) {
         TaskGraph::Node& node = *node_it;
         DCHECK_LT(0u, node.dependencies);
         node.dependencies--;
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
+    // Build new "ready to run" queue.
     task_namespace.ready_to_run_tasks.clear();
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left all nodes not present in this graph, which
-      // we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -285,13 +340,19 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
 
     // Swap task graph.
     task_namespace.graph.Swap(graph);
+    task_namespace.node_index.swap(node_index);
 
-    // Determine what tasks in old graph need to be canceled.
+    // Determine what tasks in old graph need to be canceled. These are the
+    // tasks not present in the new graph.
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
+      // Skip if still part of the new graph.
+      if (FindNode(&task_namespace.graph, task_namespace.node_index, node.task))
+        continue;
+
       // Skip if already finished running task.
       if (node.task->HasFinishedRunning())
         continue;
@@ -454,7 +515,10 @@ void TaskGraphRunner::RunTaskWithLockAcquired(int thread_index) {
   // Now iterate over all dependents to decrement dependencies and check if they
   // are ready to run.
   bool ready_to_run_namespaces_has_heap_properties = true;
-  for (DependentIterator it(&task_namespace->graph, task.get()); it; ++it) {
+  for (DependentIterator it(
+           &task_namespace->graph, &task_namespace->node_index, task.get());
+       it;
+       ++it) {
     TaskGraph::Node& dependent_node = *it;
 
     DCHECK_LT(0u, dependent_node.dependencies);
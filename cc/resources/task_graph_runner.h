@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
@@ -147,9 +148,12 @@ class CC_EXPORT TaskGraphRunner : public base::DelegateSimpleThread::Delegate {
     TaskNamespace();
     ~TaskNamespace();
 
-    // Current task graph.
+    // Current task graph. Its edges are kept sorted by task.
     TaskGraph graph;
 
+    // Position of the node of each task in |graph|, sorted by task.
+    std::vector<std::pair<const Task*, size_t> > node_index;
+
     // Ordered set of tasks that are ready to run.
     PrioritizedTask::Vector ready_to_run_tasks;
 
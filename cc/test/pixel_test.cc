@@ -50,6 +50,14 @@ bool PixelTest::RunPixelTestWithReadbackTarget(
     OffscreenContextOption provide_offscreen_context,
     const base::FilePath& ref_file,
     const PixelComparator& comparator) {
+  DrawAndReadback(pass_list, target, provide_offscreen_context);
+  return PixelsMatchReference(ref_file, comparator);
+}
+
+void PixelTest::DrawAndReadback(
+    RenderPassList* pass_list,
+    RenderPass* target,
+    OffscreenContextOption provide_offscreen_context) {
   base::RunLoop run_loop;
 
   target->copy_requests.push_back(CopyOutputRequest::CreateBitmapRequest(
@@ -87,8 +95,6 @@ bool PixelTest::RunPixelTestWithReadbackTarget(
   // Wait for the readback to complete.
   resource_provider_->Finish();
   run_loop.Run();
-
-  return PixelsMatchReference(ref_file, comparator);
 }
 
 void PixelTest::ReadbackResult(base::Closure quit_run_loop,
@@ -43,6 +43,12 @@ class PixelTest : public testing::Test, RendererClient {
       const base::FilePath& ref_file,
       const PixelComparator& comparator);
 
+  // Draws |pass_list| and stores the contents of |target| in
+  // |result_bitmap_| without comparing them against a reference file.
+  void DrawAndReadback(RenderPassList* pass_list,
+                       RenderPass* target,
+                       OffscreenContextOption provide_offscreen_context);
+
   LayerTreeSettings settings_;
   gfx::Size device_viewport_size_;
   bool disable_picture_quad_image_filtering_;
@@ -993,6 +993,8 @@ void LayerTreeHost::PaintLayerContents(
       root_layer_->render_surface()->content_rect(), record_metrics_for_frame);
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  occlusion_tracker.set_max_occlusion_complexity(
+      settings_.max_occlusion_complexity);
 
   PrioritizeTextures(render_surface_layer_list,
                      occlusion_tracker.overdraw_metrics());
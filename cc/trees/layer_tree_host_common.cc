@@ -1070,7 +1070,6 @@ static void PreCalculateMetaInformation(
     num_descendants_that_draw_content = 1000;
   }
 
-  layer->draw_properties().sorted_for_recursion = false;
   layer->draw_properties().has_child_with_a_scroll_parent = false;
 
   if (layer->clip_parent())
@@ -1109,6 +1108,68 @@ static void PreCalculateMetaInformation(
       recursive_data->layer_or_descendant_has_copy_request;
 }
 
+// The values PreCalculateMetaInformation() stores on a layer.
+struct MetaInformation {
+  int num_descendants_that_draw_content;
+  int num_unclipped_descendants;
+  bool layer_or_descendant_has_copy_request;
+  bool has_child_with_a_scroll_parent;
+
+  bool operator==(const MetaInformation& other) const {
+    return num_descendants_that_draw_content ==
+               other.num_descendants_that_draw_content &&
+           num_unclipped_descendants == other.num_unclipped_descendants &&
+           layer_or_descendant_has_copy_request ==
+               other.layer_or_descendant_has_copy_request &&
+           has_child_with_a_scroll_parent ==
+               other.has_child_with_a_scroll_parent;
+  }
+};
+
+template <typename LayerType>
+static void GetMetaInformationForSubtree(LayerType* layer,
+                                         std::vector<MetaInformation>* out) {
+  MetaInformation info;
+  info.num_descendants_that_draw_content =
+      layer->draw_properties().num_descendants_that_draw_content;
+  info.num_unclipped_descendants =
+      layer->draw_properties().num_unclipped_descendants;
+  info.layer_or_descendant_has_copy_request =
+      layer->draw_properties().layer_or_descendant_has_copy_request;
+  info.has_child_with_a_scroll_parent =
+      layer->draw_properties().has_child_with_a_scroll_parent;
+  out->push_back(info);
+
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    GetMetaInformationForSubtree(
+        LayerTreeHostCommon::get_child_as_raw_ptr(layer->children(), i), out);
+  }
+}
+
+// Runs PreCalculateMetaInformation() over the tree unless the values left
+// by the last run are known to still be valid. Debug builds recompute them
+// anyway and check that reusing them would have given the same result.
+template <typename LayerType>
+static void UpdateMetaInformation(LayerType* root_layer,
+                                  bool can_reuse_meta_information) {
+  if (can_reuse_meta_information && !DCHECK_IS_ON())
+    return;
+
+  std::vector<MetaInformation> cached_meta_information;
+  if (can_reuse_meta_information)
+    GetMetaInformationForSubtree(root_layer, &cached_meta_information);
+
+  PreCalculateMetaInformationRecursiveData recursive_data;
+  PreCalculateMetaInformation(root_layer, &recursive_data);
+
+  if (can_reuse_meta_information) {
+    std::vector<MetaInformation> meta_information;
+    GetMetaInformationForSubtree(root_layer, &meta_information);
+    DCHECK(cached_meta_information == meta_information)
+        << "A layer change did not invalidate the tree's meta information";
+  }
+}
+
 static void RoundTranslationComponents(gfx::Transform* transform) {
   transform->matrix().set(0, 3, MathUtil::Round(transform->matrix().get(0, 3)));
   transform->matrix().set(1, 3, MathUtil::Round(transform->matrix().get(1, 3)));
@@ -1236,6 +1297,8 @@ static bool SortChildrenForRecursion(std::vector<LayerType*>* out,
   }
 
   DCHECK_EQ(parent.children().size(), out->size());
+  for (size_t i = 0; i < out->size(); ++i)
+    (*out)[i]->draw_properties().sorted_for_recursion = false;
   return order_changed;
 }
 
@@ -2144,8 +2207,8 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   data_for_recursion.subtree_can_use_lcd_text = inputs->can_use_lcd_text;
   data_for_recursion.subtree_is_visible_from_ancestor = true;
 
-  PreCalculateMetaInformationRecursiveData recursive_data;
-  PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
+  UpdateMetaInformation(inputs->root_layer,
+                        inputs->can_reuse_meta_information);
   std::vector<AccumulatedSurfaceState<Layer> > accumulated_surface_state;
   CalculateDrawPropertiesInternal<Layer>(inputs->root_layer,
                                          globals,
@@ -2202,8 +2265,8 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   data_for_recursion.subtree_can_use_lcd_text = inputs->can_use_lcd_text;
   data_for_recursion.subtree_is_visible_from_ancestor = true;
 
-  PreCalculateMetaInformationRecursiveData recursive_data;
-  PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
+  UpdateMetaInformation(inputs->root_layer,
+                        inputs->can_reuse_meta_information);
   std::vector<AccumulatedSurfaceState<LayerImpl> >
       accumulated_surface_state;
   CalculateDrawPropertiesInternal<LayerImpl>(inputs->root_layer,
@@ -52,6 +52,7 @@ class CC_EXPORT LayerTreeHostCommon {
           can_use_lcd_text(can_use_lcd_text),
           can_render_to_separate_surface(can_render_to_separate_surface),
           can_adjust_raster_scales(can_adjust_raster_scales),
+          can_reuse_meta_information(false),
           render_surface_layer_list(render_surface_layer_list) {}
 
     LayerType* root_layer;
@@ -64,6 +65,10 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_use_lcd_text;
     bool can_render_to_separate_surface;
     bool can_adjust_raster_scales;
+    // True if no layer in the tree has changed its children, scroll or clip
+    // parent, DrawsContent() or copy requests since the last calculation, so
+    // that the per-subtree counts it made can be used again.
+    bool can_reuse_meta_information;
     RenderSurfaceLayerListType* render_surface_layer_list;
   };
 
@@ -9607,5 +9607,82 @@ TEST_F(LayerTreeHostCommonTest, ScrollCompensationWithRounding) {
   }
 }
 
+
+TEST_F(LayerTreeHostCommonTest, ReuseMetaInformationUntilLayerChanges) {
+  FakeImplProxy proxy;
+  FakeLayerTreeHostImpl host_impl(&proxy);
+  LayerTreeImpl* tree = host_impl.active_tree();
+  gfx::Transform identity_matrix;
+
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(tree, 1);
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  root->SetDrawsContent(true);
+
+  scoped_ptr<LayerImpl> child = LayerImpl::Create(tree, 2);
+  SetLayerPropertiesForTesting(child.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(50, 50),
+                               true,
+                               false);
+  child->SetDrawsContent(true);
+  child->SetOpacity(0.5f);
+
+  scoped_ptr<LayerImpl> grand_child = LayerImpl::Create(tree, 3);
+  SetLayerPropertiesForTesting(grand_child.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(10, 10),
+                               true,
+                               false);
+  LayerImpl* child_ptr = child.get();
+  LayerImpl* grand_child_ptr = grand_child.get();
+  child->AddChild(grand_child.Pass());
+  root->AddChild(child.Pass());
+
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    // A translucent layer with no drawing descendants needs no surface.
+    EXPECT_FALSE(child_ptr->render_surface());
+    EXPECT_EQ(1u, render_surface_layer_list.size());
+  }
+
+  // Nothing that the meta information depends on changed, so reusing it
+  // must give the same result.
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_meta_information = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_FALSE(child_ptr->render_surface());
+    EXPECT_EQ(1u, render_surface_layer_list.size());
+  }
+
+  // Once the grand child draws, the child needs a surface to apply its
+  // opacity to both layers, and the tree must stop reusing the old counts.
+  grand_child_ptr->SetDrawsContent(true);
+  EXPECT_TRUE(tree->needs_update_meta_information());
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    EXPECT_TRUE(child_ptr->render_surface());
+    EXPECT_EQ(2u, render_surface_layer_list.size());
+  }
+}
+
 }  // namespace
 }  // namespace cc
@@ -752,6 +752,8 @@ DrawSwapReadbackResult::DrawResult LayerTreeHostImpl::CalculateRenderPasses(
       record_metrics_for_frame);
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  occlusion_tracker.set_max_occlusion_complexity(
+      settings_.max_occlusion_complexity);
 
   if (debug_state_.show_occluding_rects) {
     occlusion_tracker.set_occluding_screen_space_rects_container(
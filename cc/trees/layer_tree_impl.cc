@@ -93,6 +93,7 @@ LayerTreeImpl::LayerTreeImpl(LayerTreeHostImpl* layer_tree_host_impl)
       requires_high_res_to_draw_(false),
       viewport_size_invalid_(false),
       needs_update_draw_properties_(true),
+      needs_update_meta_information_(true),
       needs_full_tree_sync_(true),
       next_activation_forces_redraw_(false) {}
 
@@ -118,6 +119,7 @@ void LayerTreeImpl::SetRootLayer(scoped_ptr<LayerImpl> layer) {
   inner_viewport_scroll_layer_ = NULL;
   outer_viewport_scroll_layer_ = NULL;
   page_scale_layer_ = NULL;
+  set_needs_update_meta_information();
 
   layer_tree_host_impl_->OnCanDrawStateChangedForTree();
 }
@@ -469,7 +471,9 @@ void LayerTreeImpl::UpdateDrawProperties() {
         can_render_to_separate_surface,
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
+    inputs.can_reuse_meta_information = !needs_update_meta_information_;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    needs_update_meta_information_ = false;
   }
 
   {
@@ -173,6 +173,16 @@ class CC_EXPORT LayerTreeImpl {
     return needs_update_draw_properties_;
   }
 
+  // Called when a layer changes its children, scroll or clip parent,
+  // DrawsContent() or copy requests, so that the next UpdateDrawProperties()
+  // can not reuse the per-subtree counts of the last one.
+  void set_needs_update_meta_information() {
+    needs_update_meta_information_ = true;
+  }
+  bool needs_update_meta_information() const {
+    return needs_update_meta_information_;
+  }
+
   void set_needs_full_tree_sync(bool needs) { needs_full_tree_sync_ = needs; }
   bool needs_full_tree_sync() const { return needs_full_tree_sync_; }
 
@@ -287,6 +297,7 @@ class CC_EXPORT LayerTreeImpl {
   bool requires_high_res_to_draw_;
   bool viewport_size_invalid_;
   bool needs_update_draw_properties_;
+  bool needs_update_meta_information_;
 
   // In impl-side painting mode, this is true when the tree may contain
   // structural differences relative to the active tree.
@@ -45,6 +45,7 @@ LayerTreeSettings::LayerTreeSettings()
       default_tile_size(gfx::Size(256, 256)),
       max_untiled_layer_size(gfx::Size(512, 512)),
       minimum_occlusion_tracking_size(gfx::Size(160, 160)),
+      max_occlusion_complexity(100),
       use_pinch_zoom_scrollbars(false),
       use_pinch_virtual_viewport(false),
       // At 256x256 tiles, 128 tiles cover an area of 2048x4096 pixels.
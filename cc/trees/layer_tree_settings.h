@@ -56,6 +56,7 @@ class CC_EXPORT LayerTreeSettings {
   gfx::Size default_tile_size;
   gfx::Size max_untiled_layer_size;
   gfx::Size minimum_occlusion_tracking_size;
+  int max_occlusion_complexity;
   bool use_pinch_zoom_scrollbars;
   bool use_pinch_virtual_viewport;
   size_t max_tiles_for_interest_area;
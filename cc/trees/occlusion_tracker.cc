@@ -22,6 +22,7 @@ OcclusionTrackerBase<LayerType, RenderSurfaceType>::OcclusionTrackerBase(
     const gfx::Rect& screen_space_clip_rect, bool record_metrics_for_frame)
     : screen_space_clip_rect_(screen_space_clip_rect),
       overdraw_metrics_(OverdrawMetrics::Create(record_metrics_for_frame)),
+      max_occlusion_complexity_(0),
       occluding_screen_space_rects_(NULL),
       non_occluding_screen_space_rects_(NULL) {}
 
@@ -71,7 +72,8 @@ static Region TransformSurfaceOpaqueRegion(
     const Region& region,
     bool have_clip_rect,
     const gfx::Rect& clip_rect_in_new_target,
-    const gfx::Transform& transform) {
+    const gfx::Transform& transform,
+    int max_rects) {
   if (region.IsEmpty())
     return Region();
 
@@ -83,10 +85,13 @@ static Region TransformSurfaceOpaqueRegion(
   if (!transform.Preserves2dAxisAlignment())
     return Region();
 
-  // TODO(danakj): If the Region is too complex, degrade gracefully here by
-  // skipping rects in it.
+  // If the Region is too complex, degrade gracefully by skipping the rects
+  // past |max_rects|. Dropping occlusion is always safe.
   Region transformed_region;
-  for (Region::Iterator rects(region); rects.has_rect(); rects.next()) {
+  int num_rects = 0;
+  for (Region::Iterator rects(region);
+       rects.has_rect() && (!max_rects || num_rects < max_rects);
+       rects.next(), ++num_rects) {
     bool clipped;
     gfx::QuadF transformed_quad =
         MathUtil::MapQuad(transform, gfx::QuadF(rects.rect()), &clipped);
@@ -202,13 +207,15 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::EnterRenderTarget(
           stack_[last_index - 1].occlusion_from_outside_target,
           false,
           gfx::Rect(),
-          old_target_to_new_target_transform);
+          old_target_to_new_target_transform,
+          max_occlusion_complexity_);
   stack_[last_index].occlusion_from_outside_target.Union(
       TransformSurfaceOpaqueRegion<RenderSurfaceType>(
           stack_[last_index - 1].occlusion_from_inside_target,
           false,
           gfx::Rect(),
-          old_target_to_new_target_transform));
+          old_target_to_new_target_transform,
+          max_occlusion_complexity_));
 }
 
 template <typename LayerType, typename RenderSurfaceType>
@@ -313,14 +320,16 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::LeaveToRenderTarget(
           stack_[last_index].occlusion_from_inside_target,
           old_surface->is_clipped(),
           old_surface->clip_rect(),
-          old_surface->draw_transform());
+          old_surface->draw_transform(),
+          max_occlusion_complexity_);
   if (old_target->has_replica() && !old_target->replica_has_mask()) {
     old_occlusion_from_inside_target_in_new_target.Union(
         TransformSurfaceOpaqueRegion<RenderSurfaceType>(
             stack_[last_index].occlusion_from_inside_target,
             old_surface->is_clipped(),
             old_surface->clip_rect(),
-            old_surface->replica_draw_transform()));
+            old_surface->replica_draw_transform(),
+            max_occlusion_complexity_));
   }
 
   Region old_occlusion_from_outside_target_in_new_target =
@@ -328,7 +337,8 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::LeaveToRenderTarget(
           stack_[last_index].occlusion_from_outside_target,
           false,
           gfx::Rect(),
-          old_surface->draw_transform());
+          old_surface->draw_transform(),
+          max_occlusion_complexity_);
 
   gfx::Rect unoccluded_surface_rect;
   gfx::Rect unoccluded_replica_rect;
@@ -435,6 +445,11 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::
         layer->render_target()->render_surface()->content_rect());
   }
 
+  if (max_occlusion_complexity_ &&
+      stack_.back().occlusion_from_inside_target.GetRegionComplexity() >=
+          max_occlusion_complexity_)
+    return;
+
   for (Region::Iterator opaque_content_rects(opaque_contents);
        opaque_content_rects.has_rect();
        opaque_content_rects.next()) {
@@ -86,6 +86,13 @@ class CC_EXPORT OcclusionTrackerBase {
     minimum_tracking_size_ = size;
   }
 
+  // Once the occlusion in a target is made of this many rects, further
+  // occluding layers are ignored rather than making every later region
+  // operation slower. Zero means no limit.
+  void set_max_occlusion_complexity(int complexity) {
+    max_occlusion_complexity_ = complexity;
+  }
+
   // The following is used for visualization purposes.
   void set_occluding_screen_space_rects_container(
       std::vector<gfx::Rect>* rects) {
@@ -144,6 +151,7 @@ class CC_EXPORT OcclusionTrackerBase {
   gfx::Rect screen_space_clip_rect_;
   scoped_ptr<class OverdrawMetrics> overdraw_metrics_;
   gfx::Size minimum_tracking_size_;
+  int max_occlusion_complexity_;
 
   // This is used for visualizing the occlusion tracking process.
   std::vector<gfx::Rect>* occluding_screen_space_rects_;
@@ -3614,6 +3614,57 @@ class OcclusionTrackerTestMinimumTrackingSize
 
 ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestMinimumTrackingSize);
 
+template <class Types>
+class OcclusionTrackerTestMaxOcclusionComplexity
+    : public OcclusionTrackerTest<Types> {
+ protected:
+  explicit OcclusionTrackerTestMaxOcclusionComplexity(bool opaque_layers)
+      : OcclusionTrackerTest<Types>(opaque_layers) {}
+  void RunMyTest() {
+    gfx::Size layer_size(10, 10);
+
+    typename Types::ContentLayerType* parent = this->CreateRoot(
+        this->identity_matrix, gfx::PointF(), gfx::Size(400, 400));
+    typename Types::LayerType* first = this->CreateDrawingLayer(
+        parent, this->identity_matrix, gfx::PointF(), layer_size, true);
+    typename Types::LayerType* second =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(20.f, 0.f),
+                                 layer_size,
+                                 true);
+    typename Types::LayerType* third =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(40.f, 0.f),
+                                 layer_size,
+                                 true);
+    this->CalcDrawEtc(parent);
+
+    TestOcclusionTrackerWithClip<typename Types::LayerType,
+                                 typename Types::RenderSurfaceType> occlusion(
+        gfx::Rect(0, 0, 1000, 1000));
+    occlusion.set_max_occlusion_complexity(2);
+
+    this->VisitLayer(third, &occlusion);
+    this->VisitLayer(second, &occlusion);
+    Region expected_occlusion =
+        UnionRegions(gfx::Rect(40, 0, 10, 10), gfx::Rect(20, 0, 10, 10));
+    EXPECT_EQ(expected_occlusion.ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+
+    // The occlusion is already made of two rects, so the last layer is not
+    // tracked.
+    this->VisitLayer(first, &occlusion);
+    EXPECT_EQ(gfx::Rect().ToString(),
+              occlusion.occlusion_from_outside_target().ToString());
+    EXPECT_EQ(expected_occlusion.ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+  }
+};
+
+ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestMaxOcclusionComplexity);
+
 template <class Types>
 class OcclusionTrackerTestScaledLayerIsClipped
     : public OcclusionTrackerTest<Types> {
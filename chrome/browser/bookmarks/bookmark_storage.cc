@@ -8,7 +8,8 @@
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
-#include "base/json/json_file_value_serializer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/metrics/histogram.h"
 #include "base/time/time.h"
@@ -53,10 +54,17 @@ void LoadCallback(const base::FilePath& path,
                   BookmarkLoadDetails* details) {
   startup_metric_utils::ScopedSlowStartupUMA
       scoped_timer("Startup.SlowStartupBookmarksLoad");
-  bool bookmark_file_exists = base::PathExists(path);
-  if (bookmark_file_exists) {
-    JSONFileValueSerializer serializer(path);
-    scoped_ptr<base::Value> root(serializer.Deserialize(NULL, NULL));
+  // The file is parsed straight out of the mapping, and with detachable
+  // children the parser copies strings out as it goes rather than copying the
+  // whole file first. Either copy would cost as much as the file itself.
+  base::MemoryMappedFile file;
+  if (base::PathExists(path) && file.Initialize(path) && file.length() > 0) {
+    scoped_ptr<base::Value> root(base::JSONReader::Read(
+        base::StringPiece(reinterpret_cast<const char*>(file.data()),
+                          file.length()),
+        base::JSON_DETACHABLE_CHILDREN));
+    UMA_HISTOGRAM_MEMORY_KB("Bookmarks.FileSizeKB",
+                            static_cast<int>(file.length() / 1024));
 
     if (root.get()) {
       // Building the index can take a while, so we do it on the background
@@ -158,8 +166,10 @@ void BookmarkStorage::BookmarkModelDeleted() {
 bool BookmarkStorage::SerializeData(std::string* output) {
   BookmarkCodec codec;
   scoped_ptr<base::Value> value(codec.Encode(model_));
+  // The file is written compactly: indentation made up a large part of the
+  // bytes rewritten on every change, and the file is not meant to be read by
+  // hand.
   JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
   return serializer.Serialize(*(value.get()));
 }
 
@@ -13,6 +13,7 @@
 
 #include "base/basictypes.h"
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/files/file_enumerator.h"
 #include "base/memory/scoped_ptr.h"
@@ -37,6 +38,7 @@
 #include "chrome/browser/history/typed_url_syncable_service.h"
 #include "chrome/browser/history/visit_filter.h"
 #include "chrome/common/chrome_constants.h"
+#include "chrome/common/chrome_switches.h"
 #include "chrome/common/importer/imported_favicon_usage.h"
 #include "chrome/common/url_constants.h"
 #include "grit/chromium_strings.h"
@@ -594,6 +596,11 @@ void HistoryBackend::InitImpl(const std::string& languages) {
       NOTREACHED();
   }
 
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kHistoryEnableURLPrefixIndex)) {
+    db_->EnableURLPrefixIndex();
+  }
+
   // Fill the in-memory database and send it back to the history service on the
   // main thread.
   InMemoryHistoryBackend* mem_backend = new InMemoryHistoryBackend;
@@ -5,8 +5,10 @@
 #ifndef CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
 #define CHROME_BROWSER_HISTORY_IN_MEMORY_URL_INDEX_TYPES_H_
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "base/strings/string16.h"
@@ -135,6 +137,91 @@ Char16Set Char16SetFromString16(const base::string16& uni_word);
 
 // Support for InMemoryURLIndex Private Data -----------------------------------
 
+// A set of IDs kept as a sorted vector. The index holds hundreds of
+// thousands of these for large histories, where a std::set's per-node
+// overhead is several times the size of the IDs themselves. Inserting IDs in
+// increasing order, which is how the index is built and restored, takes
+// amortized constant time; other insertions and erasures are linear in the
+// size of the set. Supports enough of the std::set interface for the index's
+// use, including std::inserter and the <algorithm> set operations.
+template <typename T>
+class SortedIDSet {
+ public:
+  typedef T key_type;
+  typedef T value_type;
+  typedef const T& const_reference;
+  typedef typename std::vector<T>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+  typedef size_t size_type;
+
+  SortedIDSet() {}
+
+  // Takes the contents of |ids|, which may be unsorted and contain
+  // duplicates. This is much faster than inserting the IDs one at a time
+  // when they are not in order.
+  explicit SortedIDSet(std::vector<T>* ids) {
+    ids_.swap(*ids);
+    std::sort(ids_.begin(), ids_.end());
+    ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+  }
+
+  const_iterator begin() const { return ids_.begin(); }
+  const_iterator end() const { return ids_.end(); }
+  size_type size() const { return ids_.size(); }
+  bool empty() const { return ids_.empty(); }
+
+  const_iterator find(const T& id) const {
+    const_iterator pos = std::lower_bound(ids_.begin(), ids_.end(), id);
+    return (pos != ids_.end() && *pos == id) ? pos : ids_.end();
+  }
+
+  size_type count(const T& id) const {
+    return std::binary_search(ids_.begin(), ids_.end(), id) ? 1 : 0;
+  }
+
+  std::pair<iterator, bool> insert(const T& id) {
+    if (ids_.empty() || ids_.back() < id) {
+      ids_.push_back(id);
+      return std::make_pair(iterator(ids_.end() - 1), true);
+    }
+    typename std::vector<T>::iterator pos =
+        std::lower_bound(ids_.begin(), ids_.end(), id);
+    if (*pos == id)
+      return std::make_pair(iterator(pos), false);
+    return std::make_pair(iterator(ids_.insert(pos, id)), true);
+  }
+
+  // The hint is ignored; this exists for std::inserter.
+  iterator insert(iterator hint, const T& id) { return insert(id).first; }
+
+  // Merges in the IDs in [first, last), which need not be sorted.
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    size_t old_size = ids_.size();
+    ids_.insert(ids_.end(), first, last);
+    std::sort(ids_.begin() + old_size, ids_.end());
+    std::inplace_merge(ids_.begin(), ids_.begin() + old_size, ids_.end());
+    ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+  }
+
+  size_type erase(const T& id) {
+    typename std::vector<T>::iterator pos =
+        std::lower_bound(ids_.begin(), ids_.end(), id);
+    if (pos == ids_.end() || *pos != id)
+      return 0;
+    ids_.erase(pos);
+    return 1;
+  }
+
+  void clear() { ids_.clear(); }
+  void swap(SortedIDSet& other) { ids_.swap(other.ids_); }
+
+  bool operator==(const SortedIDSet& other) const { return ids_ == other.ids_; }
+
+ private:
+  std::vector<T> ids_;
+};
+
 // An index into a list of all of the words we have indexed.
 typedef size_t WordID;
 
@@ -142,12 +229,12 @@ typedef size_t WordID;
 typedef std::map<base::string16, WordID> WordMap;
 
 // A map from character to the word_ids of words containing that character.
-typedef std::set<WordID> WordIDSet;  // An index into the WordList.
+typedef SortedIDSet<WordID> WordIDSet;  // An index into the WordList.
 typedef std::map<base::char16, WordIDSet> CharWordIDMap;
 
 // A map from word (by word_id) to history items containing that word.
 typedef history::URLID HistoryID;
-typedef std::set<HistoryID> HistoryIDSet;
+typedef SortedIDSet<HistoryID> HistoryIDSet;
 typedef std::vector<HistoryID> HistoryIDVector;
 typedef std::map<WordID, HistoryIDSet> WordIDHistoryMap;
 typedef std::map<HistoryID, WordIDSet> HistoryIDWordMap;
@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
@@ -147,4 +149,43 @@ TEST_F(InMemoryURLIndexTypesTest, OffsetsAndTermMatches) {
     EXPECT_EQ(expected_offsets_b[i], matches_b[i].offset);
 }
 
+TEST_F(InMemoryURLIndexTypesTest, SortedIDSet) {
+  SortedIDSet<size_t> id_set;
+  EXPECT_TRUE(id_set.insert(5).second);
+  EXPECT_TRUE(id_set.insert(9).second);
+  EXPECT_TRUE(id_set.insert(1).second);
+  EXPECT_FALSE(id_set.insert(5).second);
+  const size_t expected_a[] = {1, 5, 9};
+  ASSERT_EQ(arraysize(expected_a), id_set.size());
+  EXPECT_TRUE(std::equal(id_set.begin(), id_set.end(), expected_a));
+  EXPECT_EQ(1U, id_set.count(9));
+  EXPECT_EQ(0U, id_set.count(4));
+  EXPECT_TRUE(id_set.find(4) == id_set.end());
+
+  // Merging an unsorted range with duplicates.
+  const size_t more_ids[] = {7, 1, 3, 9, 3};
+  id_set.insert(more_ids, more_ids + arraysize(more_ids));
+  const size_t expected_b[] = {1, 3, 5, 7, 9};
+  ASSERT_EQ(arraysize(expected_b), id_set.size());
+  EXPECT_TRUE(std::equal(id_set.begin(), id_set.end(), expected_b));
+
+  EXPECT_EQ(1U, id_set.erase(5));
+  EXPECT_EQ(0U, id_set.erase(5));
+
+  // The set operations work as they do on a std::set.
+  std::vector<size_t> other_ids;
+  other_ids.push_back(9);
+  other_ids.push_back(3);
+  other_ids.push_back(4);
+  SortedIDSet<size_t> other_set(&other_ids);
+  SortedIDSet<size_t> intersection;
+  std::set_intersection(id_set.begin(), id_set.end(),
+                        other_set.begin(), other_set.end(),
+                        std::inserter(intersection, intersection.begin()));
+  const size_t expected_c[] = {3, 9};
+  ASSERT_EQ(arraysize(expected_c), intersection.size());
+  EXPECT_TRUE(std::equal(intersection.begin(), intersection.end(),
+                         expected_c));
+}
+
 }  // namespace history
@@ -10,7 +10,10 @@
 #include <vector>
 
 #include "base/i18n/case_conversion.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/url_prefix_index.h"
 #include "chrome/common/url_constants.h"
 #include "net/base/net_util.h"
 #include "sql/statement.h"
@@ -41,7 +44,8 @@ bool URLDatabase::URLEnumerator::GetNextURL(URLRow* r) {
 }
 
 URLDatabase::URLDatabase()
-    : has_keyword_search_terms_(false) {
+    : has_keyword_search_terms_(false),
+      use_prefix_index_(false) {
 }
 
 URLDatabase::~URLDatabase() {
@@ -127,7 +131,11 @@ bool URLDatabase::UpdateURLRow(URLID url_id,
   statement.BindInt(4, info.hidden() ? 1 : 0);
   statement.BindInt64(5, url_id);
 
-  return statement.Run();
+  if (!statement.Run())
+    return false;
+  if (prefix_index_)
+    prefix_index_->UpdateURL(url_id, info);
+  return true;
 }
 
 URLID URLDatabase::AddURLInternal(const history::URLRow& info,
@@ -153,7 +161,8 @@ URLID URLDatabase::AddURLInternal(const history::URLRow& info,
 
   sql::Statement statement(GetDB().GetCachedStatement(
       sql::StatementID(statement_name), statement_sql));
-  statement.BindString(0, GURLToDatabaseURL(info.url()));
+  const std::string url = GURLToDatabaseURL(info.url());
+  statement.BindString(0, url);
   statement.BindString16(1, info.title());
   statement.BindInt(2, info.visit_count());
   statement.BindInt(3, info.typed_count());
@@ -165,7 +174,10 @@ URLID URLDatabase::AddURLInternal(const history::URLRow& info,
             << " to table history.urls.";
     return 0;
   }
-  return GetDB().GetLastInsertRowId();
+  URLID id = GetDB().GetLastInsertRowId();
+  if (!is_temporary && prefix_index_)
+    prefix_index_->AddURL(id, url, info);
+  return id;
 }
 
 bool URLDatabase::DeleteURLRow(URLID id) {
@@ -175,6 +187,8 @@ bool URLDatabase::DeleteURLRow(URLID id) {
 
   if (!statement.Run())
     return false;
+  if (prefix_index_)
+    prefix_index_->DeleteURL(id);
 
   // And delete any keyword visits.
   return !has_keyword_search_terms_ || DeleteKeywordSearchTermForURL(id);
@@ -192,6 +206,9 @@ bool URLDatabase::CommitTemporaryURLTable() {
   // Note that the main database overrides this to additionally create the
   // supplimentary indices that the archived database doesn't need.
 
+  // The prefix index is rebuilt from the new table when next needed.
+  prefix_index_.reset();
+
   // Swap the url table out and replace it with the temporary one.
   if (!GetDB().Execute("DROP TABLE urls")) {
     NOTREACHED() << GetDB().GetErrorMessage();
@@ -244,6 +261,19 @@ bool URLDatabase::AutocompleteForPrefix(const std::string& prefix,
   // as bookmarks is no longer part of the db we no longer include the order
   // by clause.
   results->clear();
+  if (use_prefix_index_) {
+    std::vector<URLID> ids;
+    GetURLPrefixIndex()->AutocompleteForPrefix(prefix, max_results,
+                                               typed_only, &ids);
+    for (std::vector<URLID>::const_iterator i = ids.begin(); i != ids.end();
+         ++i) {
+      history::URLRow info;
+      if (GetURLRow(*i, &info) && info.url().is_valid())
+        results->push_back(info);
+    }
+    return !results->empty();
+  }
+
   const char* sql;
   int line;
   if (typed_only) {
@@ -282,6 +312,10 @@ bool URLDatabase::AutocompleteForPrefix(const std::string& prefix,
   return !results->empty();
 }
 
+void URLDatabase::EnableURLPrefixIndex() {
+  use_prefix_index_ = true;
+}
+
 bool URLDatabase::IsTypedHost(const std::string& host) {
   const char* schemes[] = {
     content::kHttpScheme,
@@ -585,6 +619,31 @@ bool URLDatabase::CreateURLTable(bool is_temporary) {
   return GetDB().Execute(sql.c_str());
 }
 
+URLPrefixIndex* URLDatabase::GetURLPrefixIndex() {
+  if (prefix_index_)
+    return prefix_index_.get();
+
+  base::TimeTicks begin_time = base::TimeTicks::Now();
+  prefix_index_.reset(new URLPrefixIndex);
+  sql::Statement statement(GetDB().GetUniqueStatement(
+      "SELECT id, url, visit_count, typed_count, last_visit_time, hidden "
+      "FROM urls"));
+  while (statement.Step()) {
+    URLRow row;
+    row.set_visit_count(statement.ColumnInt(2));
+    row.set_typed_count(statement.ColumnInt(3));
+    row.set_last_visit(
+        base::Time::FromInternalValue(statement.ColumnInt64(4)));
+    row.set_hidden(statement.ColumnInt(5) != 0);
+    prefix_index_->AddURL(statement.ColumnInt64(0), statement.ColumnString(1),
+                          row);
+  }
+  UMA_HISTOGRAM_TIMES("History.URLPrefixIndexBuildTime",
+                      base::TimeTicks::Now() - begin_time);
+  UMA_HISTOGRAM_COUNTS("History.URLPrefixIndexSize", prefix_index_->size());
+  return prefix_index_.get();
+}
+
 bool URLDatabase::CreateMainURLIndex() {
   // Index over URLs so we can quickly look up based on URL.
   return GetDB().Execute(
@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_HISTORY_URL_DATABASE_H_
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/history/query_parser.h"
 #include "chrome/browser/search_engines/template_url_id.h"
@@ -19,6 +20,7 @@ class Connection;
 
 namespace history {
 
+class URLPrefixIndex;
 class VisitDatabase;  // For friend statement.
 
 // Encapsulates an SQL database that holds URL info.  This is a subset of the
@@ -161,6 +163,12 @@ class URLDatabase {
                              bool typed_only,
                              URLRows* results);
 
+  // Makes AutocompleteForPrefix() look URLs up in a URLPrefixIndex, built on
+  // first use, instead of querying the urls table. The index is kept up to
+  // date by this class's URL table functions, so this must only be enabled
+  // for databases whose urls table is not also written to directly.
+  void EnableURLPrefixIndex();
+
   // Returns true if the database holds some past typed navigation to a URL on
   // the provided hostname.
   bool IsTypedHost(const std::string& host);
@@ -283,6 +291,14 @@ class URLDatabase {
 
   QueryParser query_parser_;
 
+  // Returns the prefix index, building it from the urls table if needed.
+  URLPrefixIndex* GetURLPrefixIndex();
+
+  // Set by EnableURLPrefixIndex(). |prefix_index_| is built lazily, and is
+  // dropped when the urls table is replaced wholesale.
+  bool use_prefix_index_;
+  scoped_ptr<URLPrefixIndex> prefix_index_;
+
   DISALLOW_COPY_AND_ASSIGN(URLDatabase);
 };
 
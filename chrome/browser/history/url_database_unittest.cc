@@ -221,6 +221,67 @@ TEST_F(URLDatabaseTest, EnumeratorForSignificant) {
   EXPECT_EQ(3, row_count);
 }
 
+// Test that the prefix index returns what the urls table query does, and
+// follows the table's updates.
+TEST_F(URLDatabaseTest, AutocompleteForPrefixWithIndex) {
+  const char* kURLs[] = {
+    "http://www.google.com/",
+    "http://www.google.com/search",
+    "http://www.goodness.com/",
+    "http://www.gopher.com/",
+    "http://www.example.com/",
+  };
+  URLID ids[arraysize(kURLs)];
+  for (size_t i = 0; i < arraysize(kURLs); ++i) {
+    URLRow row((GURL(kURLs[i])));
+    row.set_visit_count(static_cast<int>(10 + i));
+    row.set_typed_count(static_cast<int>(i % 3));
+    row.set_hidden(i == 3);
+    ids[i] = AddURL(row);
+    ASSERT_NE(0, ids[i]);
+  }
+
+  const char* kPrefixes[] = {"http://www.go", "http://www.google.com/", "x"};
+  std::vector<URLRows> expected;
+  for (size_t i = 0; i < arraysize(kPrefixes); ++i) {
+    for (int typed_only = 0; typed_only < 2; ++typed_only) {
+      URLRows results;
+      AutocompleteForPrefix(kPrefixes[i], 10, typed_only != 0, &results);
+      expected.push_back(results);
+    }
+  }
+
+  EnableURLPrefixIndex();
+  std::vector<URLRows>::const_iterator expected_results = expected.begin();
+  for (size_t i = 0; i < arraysize(kPrefixes); ++i) {
+    for (int typed_only = 0; typed_only < 2; ++typed_only) {
+      URLRows results;
+      AutocompleteForPrefix(kPrefixes[i], 10, typed_only != 0, &results);
+      ASSERT_EQ(expected_results->size(), results.size());
+      for (size_t j = 0; j < results.size(); ++j)
+        EXPECT_EQ((*expected_results)[j].id(), results[j].id());
+      ++expected_results;
+    }
+  }
+
+  // Updates, deletions and additions are reflected in the index.
+  URLRow row;
+  ASSERT_TRUE(GetURLRow(ids[2], &row));
+  row.set_typed_count(5);
+  ASSERT_TRUE(UpdateURLRow(ids[2], row));
+  ASSERT_TRUE(DeleteURLRow(ids[1]));
+  URLRow new_row(GURL("http://www.googol.com/"));
+  new_row.set_typed_count(1);
+  URLID new_id = AddURL(new_row);
+  ASSERT_NE(0, new_id);
+
+  URLRows results;
+  AutocompleteForPrefix("http://www.go", 2, true, &results);
+  ASSERT_EQ(2U, results.size());
+  EXPECT_EQ(ids[2], results[0].id());
+  EXPECT_EQ(new_id, results[1].id());
+}
+
 // Test GetKeywordSearchTermRows and DeleteSearchTerm
 TEST_F(URLDatabaseTest, GetAndDeleteKeywordSearchTermByTerm) {
   URLRow url_info1(GURL("http://www.google.com/"));
@@ -216,9 +216,8 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
                       history_ids.begin() + kItemsToScoreLimit,
                       history_ids.end(),
                       item_factor_functor);
-    history_id_set.clear();
-    std::copy(history_ids.begin(), history_ids.begin() + kItemsToScoreLimit,
-              std::inserter(history_id_set, history_id_set.end()));
+    history_ids.resize(kItemsToScoreLimit);
+    HistoryIDSet(&history_ids).swap(history_id_set);
     post_filter_item_count_ = history_id_set.size();
   }
 
@@ -622,31 +621,34 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
 
     // We must filter the word list because the resulting word set surely
     // contains words which do not have the search term as a proper subset.
+    WordIDSet filtered_word_id_set;
     for (WordIDSet::iterator word_set_iter = word_id_set.begin();
-         word_set_iter != word_id_set.end(); ) {
-      if (word_list_[*word_set_iter].find(term) == base::string16::npos)
-        word_id_set.erase(word_set_iter++);
-      else
-        ++word_set_iter;
+         word_set_iter != word_id_set.end(); ++word_set_iter) {
+      if (word_list_[*word_set_iter].find(term) != base::string16::npos)
+        filtered_word_id_set.insert(*word_set_iter);
     }
+    word_id_set.swap(filtered_word_id_set);
   } else {
     word_id_set = WordIDSetForTermChars(Char16SetFromString16(term));
   }
 
   // If any words resulted then we can compose a set of history IDs by unioning
-  // the sets from each word.
+  // the sets from each word. The IDs are gathered first and sorted once, rather
+  // than merged into the result one word at a time.
   HistoryIDSet history_id_set;
   if (!word_id_set.empty()) {
+    HistoryIDVector history_ids;
     for (WordIDSet::iterator word_id_iter = word_id_set.begin();
          word_id_iter != word_id_set.end(); ++word_id_iter) {
       WordID word_id = *word_id_iter;
       WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
       if (word_iter != word_id_history_map_.end()) {
         HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
+        history_ids.insert(history_ids.end(), word_history_id_set.begin(),
+                           word_history_id_set.end());
       }
     }
+    HistoryIDSet(&history_ids).swap(history_id_set);
   }
 
   // Record a new cache entry for this word if the term is longer than
@@ -0,0 +1,91 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/url_prefix_index.h"
+
+#include <algorithm>
+
+namespace history {
+
+URLPrefixIndex::URLPrefixIndex() {
+}
+
+URLPrefixIndex::~URLPrefixIndex() {
+}
+
+void URLPrefixIndex::AddURL(URLID id,
+                            const std::string& url,
+                            const URLRow& row) {
+  DeleteURL(id);
+
+  std::pair<EntryMap::iterator, bool> inserted =
+      entries_.insert(std::make_pair(url, Entry()));
+  if (!inserted.second) {
+    // The urls table should never hold the same URL twice, but if it does
+    // the newest row wins.
+    ids_.erase(inserted.first->second.id);
+  }
+  Entry& entry = inserted.first->second;
+  entry.id = id;
+  SetRankingFields(row, &entry);
+  ids_[id] = inserted.first;
+}
+
+void URLPrefixIndex::UpdateURL(URLID id, const URLRow& row) {
+  IDMap::iterator found = ids_.find(id);
+  if (found != ids_.end())
+    SetRankingFields(row, &found->second->second);
+}
+
+void URLPrefixIndex::DeleteURL(URLID id) {
+  IDMap::iterator found = ids_.find(id);
+  if (found == ids_.end())
+    return;
+  entries_.erase(found->second);
+  ids_.erase(found);
+}
+
+void URLPrefixIndex::AutocompleteForPrefix(const std::string& prefix,
+                                           size_t max_results,
+                                           bool typed_only,
+                                           std::vector<URLID>* ids) const {
+  ids->clear();
+
+  std::vector<EntryMap::const_iterator> candidates;
+  for (EntryMap::const_iterator i = entries_.lower_bound(prefix);
+       i != entries_.end() && i->first.compare(0, prefix.size(), prefix) == 0;
+       ++i) {
+    if (i->second.hidden || (typed_only && i->second.typed_count <= 0))
+      continue;
+    candidates.push_back(i);
+  }
+
+  size_t num_results = std::min(max_results, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + num_results,
+                    candidates.end(), &URLPrefixIndex::RanksHigher);
+  for (size_t i = 0; i < num_results; ++i)
+    ids->push_back(candidates[i]->second.id);
+}
+
+// static
+void URLPrefixIndex::SetRankingFields(const URLRow& row, Entry* entry) {
+  entry->visit_count = row.visit_count();
+  entry->typed_count = row.typed_count();
+  entry->last_visit = row.last_visit();
+  entry->hidden = row.hidden();
+}
+
+// static
+bool URLPrefixIndex::RanksHigher(const EntryMap::const_iterator& a,
+                                 const EntryMap::const_iterator& b) {
+  if (a->second.typed_count != b->second.typed_count)
+    return a->second.typed_count > b->second.typed_count;
+  if (a->second.visit_count != b->second.visit_count)
+    return a->second.visit_count > b->second.visit_count;
+  if (a->second.last_visit != b->second.last_visit)
+    return a->second.last_visit > b->second.last_visit;
+  return a->first < b->first;
+}
+
+}  // namespace history
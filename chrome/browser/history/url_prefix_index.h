@@ -0,0 +1,78 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
+#define CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/history_types.h"
+
+namespace history {
+
+// An in-memory copy of the urls table, sorted by URL and holding only the
+// columns URL autocomplete ranks by. A prefix query walks the matching range
+// directly, where SQLite would fetch and sort every matching row: for the
+// short prefixes of the first few keystrokes that is most of the table.
+//
+// The index is not tied to a database; URLDatabase keeps it in sync with the
+// writes it makes.
+class URLPrefixIndex {
+ public:
+  URLPrefixIndex();
+  ~URLPrefixIndex();
+
+  // Indexes the URL with ID |id| and spec |url|, as stored in the database,
+  // taking the ranking fields from |row|. Replaces any existing entry for
+  // |id| or |url|.
+  void AddURL(URLID id, const std::string& url, const URLRow& row);
+
+  // Updates the ranking fields of the URL with ID |id| from |row|. The URL
+  // itself can not change.
+  void UpdateURL(URLID id, const URLRow& row);
+
+  void DeleteURL(URLID id);
+
+  // Fills |ids| with the IDs of up to |max_results| URLs beginning with
+  // |prefix|, in the order URLDatabase::AutocompleteForPrefix() returns them.
+  // Hidden URLs, and if |typed_only| is true untyped URLs, are skipped.
+  void AutocompleteForPrefix(const std::string& prefix,
+                             size_t max_results,
+                             bool typed_only,
+                             std::vector<URLID>* ids) const;
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    URLID id;
+    int visit_count;
+    int typed_count;
+    base::Time last_visit;
+    bool hidden;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+  typedef base::hash_map<URLID, EntryMap::iterator> IDMap;
+
+  static void SetRankingFields(const URLRow& row, Entry* entry);
+
+  // Orders by typed count, then visit count, then visit time, all
+  // descending, with ties broken by URL.
+  static bool RanksHigher(const EntryMap::const_iterator& a,
+                          const EntryMap::const_iterator& b);
+
+  EntryMap entries_;
+  IDMap ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPrefixIndex);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_URL_PREFIX_INDEX_H_
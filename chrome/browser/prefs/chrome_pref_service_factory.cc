@@ -5,6 +5,7 @@
 #include "chrome/browser/prefs/chrome_pref_service_factory.h"
 
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
@@ -37,6 +38,7 @@
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/ui/profile_error_dialog.h"
 #include "chrome/common/chrome_constants.h"
+#include "chrome/common/chrome_switches.h"
 #include "chrome/common/pref_names.h"
 #include "components/user_prefs/pref_registry_syncable.h"
 #include "content/public/browser/browser_context.h"
@@ -344,11 +346,16 @@ void PrepareBuilder(
   scoped_ptr<PrefFilter> pref_filter;
   if (pref_hash_store)
     pref_filter = CreatePrefHashFilter(pref_hash_store.Pass());
-  factory->set_user_prefs(
+  scoped_refptr<JsonPrefStore> user_prefs(
       new JsonPrefStore(
           pref_filename,
           pref_io_task_runner,
           pref_filter.Pass()));
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnablePreferencesJournal)) {
+    user_prefs->EnableJournal();
+  }
+  factory->set_user_prefs(user_prefs);
 }
 
 // An in-memory PrefStore backed by an immutable DictionaryValue.
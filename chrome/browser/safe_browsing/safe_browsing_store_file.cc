@@ -4,6 +4,9 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
 
@@ -81,22 +84,63 @@ bool WriteItem(const T& item, FILE* fp, base::MD5Context* context) {
   return true;
 }
 
+// Items are moved to and from the file in batches of about this many
+// bytes, so that a large container costs one stdio call and one
+// checksum update per batch rather than per item, while the staging
+// buffer stays small.
+const size_t kBatchBytes = 32 * 1024;
+
+// Number of items of type |T| in a batch.
+template <class T>
+size_t BatchCount() {
+  return std::max(kBatchBytes / sizeof(T), static_cast<size_t>(1));
+}
+
+// Write the items in |batch| to |fp|, and fold the output data into the
+// checksum in |context|, if non-NULL.  Return true on success.
+template <class T>
+bool WriteBatch(const std::vector<T>& batch, FILE* fp,
+                base::MD5Context* context) {
+  if (batch.empty())
+    return true;
+
+  const size_t ret = fwrite(&batch[0], sizeof(T), batch.size(), fp);
+  if (ret != batch.size())
+    return false;
+
+  if (context) {
+    base::MD5Update(context,
+                    base::StringPiece(reinterpret_cast<const char*>(&batch[0]),
+                                      batch.size() * sizeof(T)));
+  }
+  return true;
+}
+
 // Read |count| items into |values| from |fp|, and fold them into the
 // checksum in |context|.  Returns true on success.
 template <typename CT>
 bool ReadToContainer(CT* values, size_t count, FILE* fp,
                      base::MD5Context* context) {
-  if (!count)
-    return true;
+  typedef typename CT::value_type ValueType;
 
-  for (size_t i = 0; i < count; ++i) {
-    typename CT::value_type value;
-    if (!ReadItem(&value, fp, context))
+  std::vector<ValueType> batch;
+  while (count) {
+    batch.resize(std::min(count, BatchCount<ValueType>()));
+    const size_t ret = fread(&batch[0], sizeof(ValueType), batch.size(), fp);
+    if (ret != batch.size())
       return false;
 
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(reinterpret_cast<char*>(&batch[0]),
+                                        batch.size() * sizeof(ValueType)));
+    }
+
     // push_back() is more obvious, but coded this way std::set can
     // also be read.
-    values->insert(values->end(), value);
+    for (size_t i = 0; i < batch.size(); ++i)
+      values->insert(values->end(), batch[i]);
+    count -= batch.size();
   }
 
   return true;
@@ -107,15 +151,24 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
 template <typename CT>
 bool WriteContainer(const CT& values, FILE* fp,
                     base::MD5Context* context) {
+  typedef typename CT::value_type ValueType;
+
   if (values.empty())
     return true;
 
+  const size_t batch_count = BatchCount<ValueType>();
+  std::vector<ValueType> batch;
+  batch.reserve(std::min(values.size(), batch_count));
   for (typename CT::const_iterator iter = values.begin();
        iter != values.end(); ++iter) {
-    if (!WriteItem(*iter, fp, context))
-      return false;
+    batch.push_back(*iter);
+    if (batch.size() == batch_count) {
+      if (!WriteBatch(batch, fp, context))
+        return false;
+      batch.clear();
+    }
   }
-  return true;
+  return WriteBatch(batch, fp, context);
 }
 
 // Delete the chunks in |deleted| from |chunks|.
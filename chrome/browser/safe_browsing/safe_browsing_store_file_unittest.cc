@@ -187,4 +187,40 @@ TEST_F(SafeBrowsingStoreFileTest, CheckValidityChecksum) {
   EXPECT_TRUE(store_->CancelUpdate());
 }
 
+// Test a store large enough that its data is read and written in
+// several batches.
+TEST_F(SafeBrowsingStoreFileTest, ManyPrefixes) {
+  const int32 kChunkId = 1;
+  const size_t kPrefixCount = 10000;
+
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(kChunkId);
+  for (size_t i = 0; i < kPrefixCount; ++i)
+    EXPECT_TRUE(store_->WriteAddPrefix(kChunkId, static_cast<SBPrefix>(i)));
+  EXPECT_TRUE(store_->FinishChunk());
+
+  std::vector<SBAddFullHash> pending_adds;
+  SBAddPrefixes add_prefixes_result;
+  std::vector<SBAddFullHash> add_full_hashes_result;
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds,
+                                   &add_prefixes_result,
+                                   &add_full_hashes_result));
+  ASSERT_EQ(kPrefixCount, add_prefixes_result.size());
+
+  // The checksum covers every batch.
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->CheckValidity());
+  EXPECT_TRUE(store_->CancelUpdate());
+  EXPECT_FALSE(corruption_detected_);
+
+  SBAddPrefixes add_prefixes;
+  EXPECT_TRUE(store_->GetAddPrefixes(&add_prefixes));
+  ASSERT_EQ(kPrefixCount, add_prefixes.size());
+  for (size_t i = 0; i < kPrefixCount; ++i) {
+    EXPECT_EQ(kChunkId, add_prefixes[i].chunk_id);
+    EXPECT_EQ(static_cast<SBPrefix>(i), add_prefixes[i].prefix);
+  }
+}
+
 }  // namespace
@@ -35,10 +35,6 @@ class SessionBackend : public base::RefCountedThreadSafe<SessionBackend> {
   typedef SessionCommand::id_type id_type;
   typedef SessionCommand::size_type size_type;
 
-  // Initial size of the buffer used in reading the file. This is exposed
-  // for testing.
-  static const int kFileReadBufferSize;
-
   // Creates a SessionBackend. This method is invoked on the MAIN thread,
   // and does no IO. The real work is done from Init, which is invoked on
   // the file thread.
@@ -13,6 +13,7 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
@@ -83,6 +84,10 @@ static const int kInitialDelayTimerMS = 100;
 // a tab finishes loading a new tab is loaded and the time of the delay
 // doubled.
 //
+// Background tabs are only loaded while there is memory to spare: once the
+// system reports memory pressure the tabs still waiting to be loaded are left
+// unloaded, and load when the user selects them.
+//
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
 // TabLoader is loading, it will schedule its tabs to get loaded by the same
@@ -144,6 +149,11 @@ class TabLoader : public content::NotificationObserver,
   // |LoadNextTab| to load the next tab
   void ForceLoadTimerFired();
 
+  // Invoked by |memory_pressure_listener_|. Stops loading the tabs that have
+  // not started loading yet.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   // Returns the RenderWidgetHost associated with a tab if there is one,
   // NULL otherwise.
   static RenderWidgetHost* GetRenderWidgetHost(NavigationController* tab);
@@ -184,6 +194,9 @@ class TabLoader : public content::NotificationObserver,
 
   base::OneShotTimer<TabLoader> force_load_timer_;
 
+  // Listens for memory pressure while tabs are being loaded.
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   // The time the restore process started.
   base::TimeTicks restore_started_;
 
@@ -235,6 +248,8 @@ void TabLoader::StartLoading() {
       content::NOTIFICATION_RENDER_WIDGET_HOST_DID_UPDATE_BACKING_STORE,
       content::NotificationService::AllSources());
   this_retainer_ = this;
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&TabLoader::OnMemoryPressure, base::Unretained(this))));
 #if defined(OS_CHROMEOS)
   if (!net::NetworkChangeNotifier::IsOffline()) {
     loading_ = true;
@@ -429,6 +444,28 @@ void TabLoader::ForceLoadTimerFired() {
   LoadNextTab();
 }
 
+void TabLoader::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (tabs_to_load_.empty())
+    return;
+
+  // Loading another renderer would only add to the pressure. The remaining
+  // tabs keep their restored navigation state and load when they are shown.
+  UMA_HISTOGRAM_COUNTS_100("SessionRestore.TabsNotLoadedUnderMemoryPressure",
+                           static_cast<int>(tabs_to_load_.size()));
+  force_load_timer_.Stop();
+  while (!tabs_to_load_.empty())
+    RemoveTab(tabs_to_load_.front());
+
+  // If no load is in progress nothing else will finish the restore.
+  if (tabs_loading_.empty()) {
+    if (loading_)
+      LoadNextTab();
+    if (got_first_paint_ || render_widget_hosts_to_paint_.empty())
+      this_retainer_ = NULL;
+  }
+}
+
 RenderWidgetHost* TabLoader::GetRenderWidgetHost(NavigationController* tab) {
   WebContents* web_contents = tab->GetWebContents();
   if (web_contents) {
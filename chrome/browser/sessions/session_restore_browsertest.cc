@@ -6,6 +6,7 @@
 
 #include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/process/launch.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
@@ -634,6 +635,72 @@ IN_PROC_BROWSER_TEST_F(SessionRestoreTest, RestoreForeignSession) {
   window.tabs.clear();
 }
 
+// Verifies that memory pressure during a restore leaves the background tabs
+// that have not started loading unloaded, that the restore still completes,
+// and that such a tab loads once it is activated.
+IN_PROC_BROWSER_TEST_F(SessionRestoreTest, MemoryPressureStopsLoadingTabs) {
+  // Set up the restore data -- one window with four tabs, the first selected.
+  // The selected tab and the next one start loading right away, the other two
+  // are queued.
+  const GURL urls[] = { url1_, url2_, url3_, url1_ };
+  SessionWindow window;
+  window.selected_tab_index = 0;
+  for (size_t i = 0; i < arraysize(urls); ++i) {
+    SerializedNavigationEntry nav =
+        SerializedNavigationEntryTestHelper::CreateNavigation(urls[i].spec(),
+                                                              "title");
+    sync_pb::SessionTab sync_data;
+    sync_data.set_tab_visual_index(static_cast<int>(i));
+    sync_data.set_current_navigation_index(0);
+    sync_data.set_pinned(false);
+    sync_data.add_navigation()->CopyFrom(nav.ToSyncData());
+    SessionTab* tab = new SessionTab;
+    tab->SetFromSyncData(sync_data, base::Time::Now());
+    window.tabs.push_back(tab);
+  }
+  std::vector<const SessionWindow*> session;
+  session.push_back(&window);
+
+  content::WindowedNotificationObserver restore_observer(
+      chrome::NOTIFICATION_SESSION_RESTORE_DONE,
+      content::NotificationService::AllSources());
+  std::vector<Browser*> browsers =
+      SessionRestore::RestoreForeignSessionWindows(
+          browser()->profile(), browser()->host_desktop_type(),
+          session.begin(), session.end());
+  // The pressure is delivered by a task posted now, so it reaches the tab
+  // loader before any of the restored tabs can finish loading.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  restore_observer.Wait();
+
+  ASSERT_EQ(1u, browsers.size());
+  TabStripModel* tab_strip_model = browsers[0]->tab_strip_model();
+  ASSERT_EQ(4, tab_strip_model->count());
+  EXPECT_EQ(0, tab_strip_model->active_index());
+  EXPECT_FALSE(tab_strip_model->GetWebContentsAt(0)->GetController().
+      NeedsReload());
+  EXPECT_FALSE(tab_strip_model->GetWebContentsAt(1)->GetController().
+      NeedsReload());
+  EXPECT_TRUE(tab_strip_model->GetWebContentsAt(2)->GetController().
+      NeedsReload());
+  EXPECT_TRUE(tab_strip_model->GetWebContentsAt(3)->GetController().
+      NeedsReload());
+
+  // Activating a tab that was left unloaded loads it.
+  content::WebContents* web_contents = tab_strip_model->GetWebContentsAt(2);
+  content::WindowedNotificationObserver load_observer(
+      content::NOTIFICATION_LOAD_STOP,
+      content::Source<content::NavigationController>(
+          &web_contents->GetController()));
+  tab_strip_model->ActivateTabAt(2, true);
+  load_observer.Wait();
+  EXPECT_FALSE(web_contents->GetController().NeedsReload());
+  EXPECT_EQ(url3_, web_contents->GetURL());
+  EXPECT_TRUE(tab_strip_model->GetWebContentsAt(3)->GetController().
+      NeedsReload());
+}
+
 IN_PROC_BROWSER_TEST_F(SessionRestoreTest, Basic) {
   ui_test_utils::NavigateToURL(browser(), url1_);
   ui_test_utils::NavigateToURL(browser(), url2_);
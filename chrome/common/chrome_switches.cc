@@ -709,6 +709,10 @@ const char kEnableOriginChipV2HideOnUserInput[] =
 // Enables panels (always on-top docked pop-up windows).
 const char kEnablePanels[]                  = "enable-panels";
 
+// Makes the profile preferences file append changed values to a journal
+// instead of rewriting the whole file on every change.
+const char kEnablePreferencesJournal[]      = "enable-preferences-journal";
+
 // Enable Privet storage.
 const char kEnablePrivetStorage[]     = "enable-privet-storage";
 
@@ -918,6 +922,10 @@ const char kHistoryDisableFullHistorySync[] = "disable-full-history-sync";
 // Enables grouping websites by domain and filtering them by period.
 const char kHistoryEnableGroupByDomain[]    = "enable-grouped-history";
 
+// Answers history URL autocomplete queries from an in-memory index of the
+// urls table, sorted by URL, instead of from SQLite.
+const char kHistoryEnableURLPrefixIndex[]   = "enable-history-url-prefix-index";
+
 // Specifies which page will be displayed in newly-opened tabs. We need this
 // for testing purposes so that the UI tests don't depend on what comes up for
 // http://google.com.
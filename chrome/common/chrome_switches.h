@@ -204,6 +204,7 @@ extern const char kEnableOriginChipV2HideOnUserInput[];
 extern const char kEnablePanels[];
 extern const char kEnablePasswordAutofillPublicSuffixDomainMatching[];
 extern const char kEnablePermissionsBubbles[];
+extern const char kEnablePreferencesJournal[];
 extern const char kEnableQueryExtraction[];
 extern const char kEnablePrivetStorage[];
 extern const char kEnableProfiling[];
@@ -257,6 +258,7 @@ extern const char kHelpShort[];
 extern const char kHideIcons[];
 extern const char kHistoryDisableFullHistorySync[];
 extern const char kHistoryEnableGroupByDomain[];
+extern const char kHistoryEnableURLPrefixIndex[];
 extern const char kHistoryWebHistoryUrl[];
 extern const char kHomePage[];
 extern const char kHostRules[];
@@ -40,7 +40,10 @@ const int32 VisitedLinkMaster::kFileHeaderLengthOffset = 8;
 const int32 VisitedLinkMaster::kFileHeaderUsedOffset = 12;
 const int32 VisitedLinkMaster::kFileHeaderSaltOffset = 16;
 
-const int32 VisitedLinkMaster::kFileCurrentVersion = 3;
+const int32 VisitedLinkMaster::kFileCurrentVersion = 4;
+
+// Version 3 files hold the same table, but not in Robin Hood order.
+const int32 VisitedLinkMaster::kFileUnorderedVersion = 3;
 
 // the signature at the beginning of the URL table = "VLnk" (visited links)
 const int32 VisitedLinkMaster::kFileSignature = 0x6b6e4c56;
@@ -294,7 +297,12 @@ void VisitedLinkMaster::AddURL(const GURL& url) {
     // Not rebuilding, so we want to keep the file on disk up-to-date.
     if (persist_to_disk_) {
       WriteUsedItemCountToFile();
-      WriteHashRangeToFile(index, index);
+      // Entries after |index| may have been shifted along to make room for
+      // it, up to the end of the run of used slots.
+      Hash last_hash = index;
+      while (hash_table_[IncrementHash(last_hash)] != null_fingerprint_)
+        last_hash = IncrementHash(last_hash);
+      WriteHashRangeToFile(index, last_hash);
     }
     ResizeTableIfNecessary();
   }
@@ -389,13 +397,27 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
 
   Hash cur_hash = HashFingerprint(fingerprint);
   Hash first_hash = cur_hash;
+  int32 distance = 0;
   while (true) {
     Fingerprint cur_fingerprint = FingerprintAt(cur_hash);
     if (cur_fingerprint == fingerprint)
       return null_hash_;  // This fingerprint is already in there, do nothing.
 
-    if (cur_fingerprint == null_fingerprint_) {
-      // End of probe sequence found, insert here.
+    // Insert at the end of the probe sequence, or in place of the first entry
+    // that is closer to its own hash than this one would be here. Keeping
+    // entries that have probed further ahead of those that have not bounds
+    // the length of the probe sequences, and lets IsVisited stop early.
+    if (cur_fingerprint == null_fingerprint_ ||
+        ProbeDistance(cur_fingerprint, cur_hash) < distance) {
+      // Shift the rest of the run one slot along to make room. This goes
+      // backwards from the end of the run so that readers of the shared
+      // table never miss an entry that is being moved.
+      Hash end_hash = cur_hash;
+      while (hash_table_[end_hash] != null_fingerprint_)
+        end_hash = IncrementHash(end_hash);
+      for (Hash i = end_hash; i != cur_hash; i = DecrementHash(i))
+        hash_table_[i] = hash_table_[DecrementHash(i)];
+
       hash_table_[cur_hash] = fingerprint;
       used_items_++;
       // If allowed, notify listener that a new visited link was added.
@@ -406,6 +428,7 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
 
     // Advance in the probe sequence.
     cur_hash = IncrementHash(cur_hash);
+    distance++;
     if (cur_hash == first_hash) {
       // This means that we've wrapped around and are about to go into an
       // infinite loop. Something was wrong with the hashtable resizing
@@ -545,7 +568,9 @@ bool VisitedLinkMaster::InitFromFile() {
     return false;
 
   int32 num_entries, used_count;
-  if (!ReadFileHeader(file_closer.get(), &num_entries, &used_count, salt_))
+  bool ordered;
+  if (!ReadFileHeader(file_closer.get(), &num_entries, &used_count, salt_,
+                      &ordered))
     return false;  // Header isn't valid.
 
   // Allocate and read the table.
@@ -564,6 +589,11 @@ bool VisitedLinkMaster::InitFromFile() {
 
   file_ = static_cast<FILE**>(malloc(sizeof(*file_)));
   *file_ = file_closer.release();
+
+  // Reinserting every fingerprint puts an older table in order, and writes it
+  // back out in the current format.
+  if (!ordered)
+    ResizeTable(table_length_);
   return true;
 }
 
@@ -600,7 +630,8 @@ bool VisitedLinkMaster::InitFromScratch(bool suppress_rebuild) {
 bool VisitedLinkMaster::ReadFileHeader(FILE* file,
                                        int32* num_entries,
                                        int32* used_count,
-                                       uint8 salt[LINK_SALT_LENGTH]) {
+                                       uint8 salt[LINK_SALT_LENGTH],
+                                       bool* ordered) {
   DCHECK(persist_to_disk_);
 
   // Get file size.
@@ -629,8 +660,9 @@ bool VisitedLinkMaster::ReadFileHeader(FILE* file,
   // have the effect of migrating the database.
   int32 version;
   memcpy(&version, &header[kFileHeaderVersionOffset], sizeof(version));
-  if (version != kFileCurrentVersion)
+  if (version != kFileCurrentVersion && version != kFileUnorderedVersion)
     return false;  // Bad version.
+  *ordered = (version == kFileCurrentVersion);
 
   // Read the table size and make sure it matches the file size.
   memcpy(num_entries, &header[kFileHeaderLengthOffset], sizeof(*num_entries));
@@ -737,7 +769,9 @@ bool VisitedLinkMaster::ResizeTableIfNecessary() {
   // keeping the table not very full. This is because we use linear probing
   // which increases the likelihood of clumps of entries which will reduce
   // performance.
-  const float max_table_load = 0.5f;  // Grow when we're > this full.
+  // Robin Hood ordering (see AddFingerprint) keeps the probe sequences
+  // short at higher loads than plain linear probing would.
+  const float max_table_load = 0.7f;  // Grow when we're > this full.
   const float min_table_load = 0.2f;  // Shrink when we're < this full.
 
   float load = ComputeTableLoad();
@@ -811,8 +845,8 @@ uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) const {
       16777199,  // 16M  = 16777216
       33554347};  // 32M  = 33554432
 
-  // Try to leave the table 33% full.
-  int desired = item_count * 3;
+  // Try to leave the table 50% full.
+  int desired = item_count * 2;
 
   // Find the closest prime.
   for (size_t i = 0; i < arraysize(table_sizes); i ++) {
@@ -913,7 +947,7 @@ void VisitedLinkMaster::WriteHashRangeToFile(Hash first_hash, Hash last_hash) {
     // Handle wraparound at 0. This first write is first_hash->EOF
     WriteToFile(file_, first_hash * sizeof(Fingerprint) + kFileHeaderSize,
                 &hash_table_[first_hash],
-                (table_length_ - first_hash + 1) * sizeof(Fingerprint));
+                (table_length_ - first_hash) * sizeof(Fingerprint));
 
     // Now do 0->last_lash.
     WriteToFile(file_, kFileHeaderSize, hash_table_,
@@ -159,6 +159,9 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, Delete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigDelete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigImport);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, RobinHoodOrder);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, RobinHoodWrapIsWrittenToFile);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, UpgradeUnorderedFile);
 
   // Object to rebuild the table on the history thread (see the .cc file).
   class TableBuilder;
@@ -176,6 +179,9 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // version of the file format this module currently uses
   static const int32 kFileCurrentVersion;
 
+  // An older version of the file format which is upgraded when loaded.
+  static const int32 kFileUnorderedVersion;
+
   // Bytes in the file header, including the salt.
   static const size_t kFileHeaderSize;
 
@@ -216,10 +222,11 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // asynchronous I/O operations.
   //
   // Returns true on success and places the size of the table in num_entries
-  // and the number of nonzero fingerprints in used_count. This will fail if
-  // the version of the file is not the current version of the database.
+  // and the number of nonzero fingerprints in used_count. |ordered| is set to
+  // false if the table needs to be put in order before it is used. This will
+  // fail if the version of the file is not one this database can read.
   bool ReadFileHeader(FILE* hfile, int32* num_entries, int32* used_count,
-                      uint8 salt[LINK_SALT_LENGTH]);
+                      uint8 salt[LINK_SALT_LENGTH], bool* ordered);
 
   // Fills *filename with the name of the link database filename
   bool GetDatabaseFileName(base::FilePath* filename);
@@ -45,6 +45,7 @@ bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
   // which should be enforced by AddFingerprint.
   Hash first_hash = HashFingerprint(fingerprint);
   Hash cur_hash = first_hash;
+  int32 distance = 0;
   while (true) {
     Fingerprint cur_fingerprint = FingerprintAt(cur_hash);
     if (cur_fingerprint == null_fingerprint_)
@@ -52,9 +53,18 @@ bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
     if (cur_fingerprint == fingerprint)
       return true;  // Found a match.
 
+    // The table is kept in "Robin Hood" order (see
+    // VisitedLinkMaster::AddFingerprint): had the item been added, it would
+    // have taken the place of any entry closer to its own hash than the item
+    // is here. Finding such an entry ends the search early, which keeps
+    // lookups of unvisited links short even when the table is fairly full.
+    if (ProbeDistance(cur_fingerprint, cur_hash) < distance)
+      return false;
+
     // This spot was taken, but not by the item we're looking for, search in
     // the next position.
     cur_hash++;
+    distance++;
     if (cur_hash == table_length_)
       cur_hash = 0;
     if (cur_hash == first_hash) {
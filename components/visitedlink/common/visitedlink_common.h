@@ -120,6 +120,14 @@ class VisitedLinkCommon {
     return HashFingerprint(fingerprint, table_length_);
   }
 
+  // Returns how many slots past the one it hashes to |fingerprint| is stored,
+  // given that it is stored at |table_offset|.
+  int32 ProbeDistance(Fingerprint fingerprint, Hash table_offset) const {
+    Hash home = HashFingerprint(fingerprint);
+    return table_offset >= home ? table_offset - home
+                                : table_offset + table_length_ - home;
+  }
+
   // pointer to the first item
   VisitedLinkCommon::Fingerprint* hash_table_;
 
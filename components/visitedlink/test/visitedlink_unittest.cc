@@ -280,6 +280,163 @@ TEST_F(VisitedLinkTest, Delete) {
         "Hash table has values in it.";
 }
 
+// Checks that entries which have probed further are kept ahead of those that
+// have not, and that lookups still find everything.
+TEST_F(VisitedLinkTest, RobinHoodOrder) {
+  static const int32 kInitialSize = 17;
+  ASSERT_TRUE(InitVisited(kInitialSize, true));
+
+  const VisitedLinkCommon::Fingerprint kFingerprint14a = kInitialSize * 0 + 14;
+  const VisitedLinkCommon::Fingerprint kFingerprint14b = kInitialSize * 1 + 14;
+  const VisitedLinkCommon::Fingerprint kFingerprint15 = kInitialSize * 1 + 15;
+  const VisitedLinkCommon::Fingerprint kFingerprint14c = kInitialSize * 2 + 14;
+  master_->AddFingerprint(kFingerprint14a, false);  // @14
+  master_->AddFingerprint(kFingerprint14b, false);  // @15
+  master_->AddFingerprint(kFingerprint15, false);   // @16
+
+  // This one has probed further than |kFingerprint15| by slot 16, so takes
+  // its place and pushes it along to slot 0.
+  master_->AddFingerprint(kFingerprint14c, false);
+  EXPECT_EQ(kFingerprint14c, master_->hash_table_[16]);
+  EXPECT_EQ(kFingerprint15, master_->hash_table_[0]);
+
+  EXPECT_TRUE(master_->IsVisited(kFingerprint14a));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint14b));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint14c));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint15));
+  EXPECT_FALSE(master_->IsVisited(kInitialSize * 3 + 14));
+  EXPECT_FALSE(master_->IsVisited(kInitialSize * 2 + 15));
+
+  // Deleting keeps the remaining entries reachable.
+  EXPECT_TRUE(master_->DeleteFingerprint(kFingerprint14b, false));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint14a));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint14c));
+  EXPECT_TRUE(master_->IsVisited(kFingerprint15));
+  EXPECT_EQ(3, master_->used_items_);
+}
+
+// Checks that AddURL writes entries shifted past the end of the table to the
+// right place in the file, so that it can be loaded again.
+TEST_F(VisitedLinkTest, RobinHoodWrapIsWrittenToFile) {
+  static const int32 kInitialSize = 17;
+  ASSERT_TRUE(InitVisited(kInitialSize, true));
+
+  // Find two URLs that hash to slot 15 and one that hashes to slot 16.
+  URLs urls_at_15;
+  GURL url_at_16;
+  for (int i = 0; urls_at_15.size() < 2 || url_at_16.is_empty(); i++) {
+    GURL url(TestURL(i));
+    VisitedLinkCommon::Hash hash = master_->HashFingerprint(
+        master_->ComputeURLFingerprint(url.spec().data(), url.spec().size()));
+    if (hash == 15 && urls_at_15.size() < 2)
+      urls_at_15.push_back(url);
+    else if (hash == 16 && url_at_16.is_empty())
+      url_at_16 = url;
+  }
+
+  master_->AddURL(urls_at_15[0]);  // @15
+  master_->AddURL(url_at_16);      // @16
+
+  // This one has probed further than |url_at_16| by slot 16, so takes its
+  // place and pushes it along to slot 0.
+  master_->AddURL(urls_at_15[1]);
+  EXPECT_EQ(master_->ComputeURLFingerprint(url_at_16.spec().data(),
+                                           url_at_16.spec().size()),
+            master_->hash_table_[0]);
+
+  // A file that does not match its header is thrown away, and would leave
+  // an empty table of the default size.
+  ClearDB();
+  ASSERT_TRUE(InitVisited(0, true));
+  master_->DebugValidate();
+  EXPECT_EQ(kInitialSize, master_->table_length_);
+  EXPECT_EQ(3, master_->GetUsedCount());
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[0]));
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[1]));
+  EXPECT_TRUE(master_->IsVisited(url_at_16));
+}
+
+// Checks that a version 3 file, whose table is not in Robin Hood order, is put
+// in order on load so that every URL is still found, and is written back in
+// the current format.
+TEST_F(VisitedLinkTest, UpgradeUnorderedFile) {
+  static const int32 kTableLength = 17;
+  static const int32 kUsedCount = 3;
+  const uint8 kSalt[LINK_SALT_LENGTH] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+  // Find two URLs that hash to slot 15 and one that hashes to slot 16.
+  URLs urls_at_15;
+  GURL url_at_16;
+  for (int i = 0; urls_at_15.size() < 2 || url_at_16.is_empty(); i++) {
+    GURL url(TestURL(i));
+    VisitedLinkCommon::Hash hash = VisitedLinkMaster::HashFingerprint(
+        VisitedLinkMaster::ComputeURLFingerprint(url.spec().data(),
+                                                 url.spec().size(), kSalt),
+        kTableLength);
+    if (hash == 15 && urls_at_15.size() < 2)
+      urls_at_15.push_back(url);
+    else if (hash == 16 && url_at_16.is_empty())
+      url_at_16 = url;
+  }
+  const VisitedLinkCommon::Fingerprint kFingerprint15a =
+      VisitedLinkMaster::ComputeURLFingerprint(
+          urls_at_15[0].spec().data(), urls_at_15[0].spec().size(), kSalt);
+  const VisitedLinkCommon::Fingerprint kFingerprint15b =
+      VisitedLinkMaster::ComputeURLFingerprint(
+          urls_at_15[1].spec().data(), urls_at_15[1].spec().size(), kSalt);
+  const VisitedLinkCommon::Fingerprint kFingerprint16 =
+      VisitedLinkMaster::ComputeURLFingerprint(
+          url_at_16.spec().data(), url_at_16.spec().size(), kSalt);
+
+  // Lay the table out by linear probing in insertion order, as version 3
+  // did. The second URL at 15 lands in slot 0, behind the URL at 16 which has
+  // probed less far, so a Robin Hood lookup would stop before reaching it.
+  std::vector<VisitedLinkCommon::Fingerprint> table(kTableLength, 0);
+  table[15] = kFingerprint15a;
+  table[16] = kFingerprint16;
+  table[0] = kFingerprint15b;
+
+  int32 header[4];
+  header[0] = VisitedLinkMaster::kFileSignature;
+  header[1] = VisitedLinkMaster::kFileUnorderedVersion;
+  header[2] = kTableLength;
+  header[3] = kUsedCount;
+  std::string data(reinterpret_cast<const char*>(header), sizeof(header));
+  data.append(reinterpret_cast<const char*>(kSalt), LINK_SALT_LENGTH);
+  data.append(reinterpret_cast<const char*>(&table[0]),
+              kTableLength * sizeof(VisitedLinkCommon::Fingerprint));
+  ASSERT_EQ(static_cast<int>(data.size()),
+            file_util::WriteFile(visited_file_, data.data(), data.size()));
+
+  ASSERT_TRUE(InitVisited(0, true));
+  master_->DebugValidate();
+  EXPECT_EQ(kTableLength, master_->table_length_);
+  EXPECT_EQ(kUsedCount, master_->GetUsedCount());
+  // Both URLs at 15 now come before the URL at 16, which moved to slot 0.
+  EXPECT_EQ(kFingerprint16, master_->hash_table_[0]);
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[0]));
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[1]));
+  EXPECT_TRUE(master_->IsVisited(url_at_16));
+
+  // The file now holds the ordered table in the current version.
+  ClearDB();
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(visited_file_, &contents));
+  ASSERT_EQ(data.size(), contents.size());
+  int32 version;
+  memcpy(&version,
+         contents.data() + VisitedLinkMaster::kFileHeaderVersionOffset,
+         sizeof(version));
+  EXPECT_EQ(VisitedLinkMaster::kFileCurrentVersion, version);
+
+  ASSERT_TRUE(InitVisited(0, true));
+  master_->DebugValidate();
+  EXPECT_EQ(kUsedCount, master_->GetUsedCount());
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[0]));
+  EXPECT_TRUE(master_->IsVisited(urls_at_15[1]));
+  EXPECT_TRUE(master_->IsVisited(url_at_16));
+}
+
 // When we delete more than kBigDeleteThreshold we trigger different behavior
 // where the entire file is rewritten.
 TEST_F(VisitedLinkTest, BigDelete) {
@@ -11,6 +11,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/nullable_string16.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "url/gurl.h"
@@ -92,14 +93,38 @@ class CONTENT_EXPORT DOMStorageArea
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, PurgeMemory);
+  FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, RateLimiter);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageContextImplTest, PersistentIds);
   friend class base::RefCountedThreadSafe<DOMStorageArea>;
 
+  // Tracks how much of something, commits or bytes written, has been done
+  // since the area was created and computes how long to hold off doing more
+  // to stay within |desired_rate| per |time_quantum|.
+  class CONTENT_EXPORT RateLimiter {
+   public:
+    RateLimiter(size_t desired_rate, base::TimeDelta time_quantum);
+
+    void add_samples(size_t samples) { samples_ += samples; }
+
+    // Returns how much longer than |elapsed_time| it should take to do what
+    // has been sampled so far at the desired rate.
+    base::TimeDelta ComputeDelayNeeded(
+        const base::TimeDelta elapsed_time) const;
+
+   private:
+    base::TimeDelta ComputeTimeNeeded() const;
+
+    size_t rate_;
+    size_t samples_;
+    base::TimeDelta time_quantum_;
+  };
+
   struct CommitBatch {
     bool clear_all_first;
     DOMStorageValuesMap changed_values;
     CommitBatch();
     ~CommitBatch();
+    size_t GetDataSize() const;
   };
 
   ~DOMStorageArea();
@@ -113,6 +138,7 @@ class CONTENT_EXPORT DOMStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  base::TimeDelta ComputeCommitDelay() const;
   void OnCommitTimer();
   void CommitChanges(const CommitBatch* commit_batch);
   void OnCommitComplete();
@@ -131,6 +157,13 @@ class CONTENT_EXPORT DOMStorageArea
   bool is_shutdown_;
   scoped_ptr<CommitBatch> commit_batch_;
   int commit_batches_in_flight_;
+
+  // Pages that write to storage continuously would otherwise keep the commit
+  // sequence busy; commits are spread out to keep both their number and the
+  // amount of data written within limits.
+  base::TimeTicks start_time_;
+  RateLimiter commit_rate_limiter_;
+  RateLimiter data_rate_limiter_;
 };
 
 }  // namespace content
@@ -426,6 +426,57 @@ TEST_F(DOMStorageAreaTest, PurgeMemory) {
   EXPECT_NE(original_map, area->map_.get());
 }
 
+TEST_F(DOMStorageAreaTest, RateLimiter) {
+  // Limit to 1000 samples per second.
+  DOMStorageArea::RateLimiter rate_limiter(
+      1000, base::TimeDelta::FromSeconds(1));
+
+  // No samples have been added so no time/delay should be needed.
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(1)));
+
+  // Add 2000 samples, which would take 2 seconds at the desired rate.
+  rate_limiter.add_samples(2000);
+  EXPECT_EQ(base::TimeDelta::FromSeconds(2),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(1)));
+  EXPECT_EQ(base::TimeDelta(),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta::FromSeconds(3)));
+}
+
+TEST_F(DOMStorageAreaTest, RateLimiterPartialQuantum) {
+  // Limit to 1000 samples per second.
+  DOMStorageArea::RateLimiter rate_limiter(
+      1000, base::TimeDelta::FromSeconds(1));
+
+  // Samples that are not a multiple of the rate still need time in
+  // proportion to their number.
+  rate_limiter.add_samples(500);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(500),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  rate_limiter.add_samples(1000);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(1500),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(250),
+            rate_limiter.ComputeDelayNeeded(
+                base::TimeDelta::FromMilliseconds(1250)));
+}
+
+TEST_F(DOMStorageAreaTest, RateLimiterManySamples) {
+  // Limit to 10MB per day, as for committed data.
+  DOMStorageArea::RateLimiter rate_limiter(
+      10 * 1024 * 1024, base::TimeDelta::FromHours(24));
+
+  // A long-lived area can commit far more than fits in int64 microseconds
+  // times bytes.
+  rate_limiter.add_samples(static_cast<size_t>(1000) * 1024 * 1024);
+  EXPECT_EQ(base::TimeDelta::FromHours(2400),
+            rate_limiter.ComputeDelayNeeded(base::TimeDelta()));
+}
+
 TEST_F(DOMStorageAreaTest, DatabaseFileNames) {
   struct {
     const char* origin;
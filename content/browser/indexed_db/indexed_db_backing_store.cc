@@ -4,8 +4,11 @@
 
 #include "content/browser/indexed_db/indexed_db_backing_store.h"
 
+#include "base/bind.h"
+#include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
@@ -17,9 +20,11 @@
 #include "content/browser/indexed_db/leveldb/leveldb_database.h"
 #include "content/browser/indexed_db/leveldb/leveldb_iterator.h"
 #include "content/browser/indexed_db/leveldb/leveldb_transaction.h"
+#include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
 #include "content/common/indexed_db/indexed_db_key.h"
 #include "content/common/indexed_db/indexed_db_key_path.h"
 #include "content/common/indexed_db/indexed_db_key_range.h"
+#include "content/public/common/content_switches.h"
 #include "third_party/WebKit/public/platform/WebIDBTypes.h"
 #include "third_party/WebKit/public/web/WebSerializedScriptValueVersion.h"
 #include "third_party/leveldatabase/env_chromium.h"
@@ -401,9 +406,13 @@ IndexedDBBackingStore::IndexedDBBackingStore(
     : origin_url_(origin_url),
       origin_identifier_(ComputeOriginIdentifier(origin_url)),
       db_(db.Pass()),
-      comparator_(comparator.Pass()) {}
+      comparator_(comparator.Pass()),
+      group_commit_enabled_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableIndexedDBGroupCommit)) {}
 
 IndexedDBBackingStore::~IndexedDBBackingStore() {
+  // The pending group commit task holds a reference to this object.
+  DCHECK(!group_commit_batch_);
   // db_'s destructor uses comparator_. The order of destruction is important.
   db_.reset();
   comparator_.reset();
@@ -1859,7 +1868,9 @@ IndexedDBBackingStore::Cursor::Cursor(
     const IndexedDBBackingStore::Cursor* other)
     : transaction_(other->transaction_),
       cursor_options_(other->cursor_options_),
-      current_key_(new IndexedDBKey(*other->current_key_)) {
+      current_key_(new IndexedDBKey(*other->current_key_)),
+      encoded_key_prefix_(other->encoded_key_prefix_),
+      current_encoded_key_(other->current_encoded_key_) {
   if (other->iterator_) {
     iterator_ = transaction_->CreateIterator();
 
@@ -1872,7 +1883,15 @@ IndexedDBBackingStore::Cursor::Cursor(
 
 IndexedDBBackingStore::Cursor::Cursor(LevelDBTransaction* transaction,
                                       const CursorOptions& cursor_options)
-    : transaction_(transaction), cursor_options_(cursor_options) {}
+    : transaction_(transaction), cursor_options_(cursor_options) {
+  // All keys in the cursor's range share the key prefix of its bounds.
+  StringPiece slice(cursor_options_.low_key);
+  KeyPrefix prefix;
+  bool ok = KeyPrefix::Decode(&slice, &prefix);
+  DCHECK(ok);
+  encoded_key_prefix_.assign(cursor_options_.low_key.data(),
+                             cursor_options_.low_key.size() - slice.size());
+}
 IndexedDBBackingStore::Cursor::~Cursor() {}
 
 bool IndexedDBBackingStore::Cursor::FirstSeek() {
@@ -2040,6 +2059,28 @@ bool IndexedDBBackingStore::Cursor::IsPastBounds() const {
   return compare < 0;
 }
 
+bool IndexedDBBackingStore::Cursor::DecodeCurrentKey(StringPiece* slice) {
+  if (!slice->starts_with(encoded_key_prefix_))
+    return false;
+  slice->remove_prefix(encoded_key_prefix_.size());
+
+  const char* start = slice->begin();
+  if (slice->empty() || !ExtractEncodedIDBKey(slice, NULL))
+    return false;
+  StringPiece encoded_key(start, slice->begin() - start);
+
+  // Consecutive index rows frequently share a key.
+  if (current_key_ && encoded_key == current_encoded_key_)
+    return true;
+
+  current_encoded_key_.clear();
+  StringPiece key_slice(encoded_key);
+  if (!DecodeIDBKey(&key_slice, &current_key_))
+    return false;
+  encoded_key.CopyToString(&current_encoded_key_);
+  return true;
+}
+
 const IndexedDBKey& IndexedDBBackingStore::Cursor::primary_key() const {
   return *current_key_;
 }
@@ -2085,14 +2126,11 @@ class ObjectStoreKeyCursorImpl : public IndexedDBBackingStore::Cursor {
 
 bool ObjectStoreKeyCursorImpl::LoadCurrentRow() {
   StringPiece slice(iterator_->Key());
-  ObjectStoreDataKey object_store_data_key;
-  if (!ObjectStoreDataKey::Decode(&slice, &object_store_data_key)) {
+  if (!DecodeCurrentKey(&slice)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  current_key_ = object_store_data_key.user_key();
-
   int64 version;
   slice = StringPiece(iterator_->Value());
   if (!DecodeVarInt(&slice, &version)) {
@@ -2100,10 +2138,7 @@ bool ObjectStoreKeyCursorImpl::LoadCurrentRow() {
     return false;
   }
 
-  // TODO(jsbell): This re-encodes what was just decoded; try and optimize.
-  std::string encoded_key;
-  EncodeIDBKey(*current_key_, &encoded_key);
-  record_identifier_.Reset(encoded_key, version);
+  record_identifier_.Reset(current_encoded_key(), version);
 
   return true;
 }
@@ -2142,14 +2177,11 @@ class ObjectStoreCursorImpl : public IndexedDBBackingStore::Cursor {
 
 bool ObjectStoreCursorImpl::LoadCurrentRow() {
   StringPiece slice(iterator_->Key());
-  ObjectStoreDataKey object_store_data_key;
-  if (!ObjectStoreDataKey::Decode(&slice, &object_store_data_key)) {
+  if (!DecodeCurrentKey(&slice)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  current_key_ = object_store_data_key.user_key();
-
   int64 version;
   slice = StringPiece(iterator_->Value());
   if (!DecodeVarInt(&slice, &version)) {
@@ -2157,10 +2189,7 @@ bool ObjectStoreCursorImpl::LoadCurrentRow() {
     return false;
   }
 
-  // TODO(jsbell): This re-encodes what was just decoded; try and optimize.
-  std::string encoded_key;
-  EncodeIDBKey(*current_key_, &encoded_key);
-  record_identifier_.Reset(encoded_key, version);
+  record_identifier_.Reset(current_encoded_key(), version);
 
   current_value_ = slice.as_string();
   return true;
@@ -2215,16 +2244,14 @@ class IndexKeyCursorImpl : public IndexedDBBackingStore::Cursor {
 };
 
 bool IndexKeyCursorImpl::LoadCurrentRow() {
+  // The sequence number and primary key that follow the user key in the
+  // index key are not needed; the primary key is also stored in the value.
   StringPiece slice(iterator_->Key());
-  IndexDataKey index_data_key;
-  if (!IndexDataKey::Decode(&slice, &index_data_key)) {
+  if (!DecodeCurrentKey(&slice)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  current_key_ = index_data_key.user_key();
-  DCHECK(current_key_);
-
   slice = StringPiece(iterator_->Value());
   int64 index_data_version;
   if (!DecodeVarInt(&slice, &index_data_version)) {
@@ -2232,15 +2259,16 @@ bool IndexKeyCursorImpl::LoadCurrentRow() {
     return false;
   }
 
+  const char* encoded_primary_key = slice.begin();
   if (!DecodeIDBKey(&slice, &primary_key_) || !slice.empty()) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  std::string primary_leveldb_key =
-      ObjectStoreDataKey::Encode(index_data_key.DatabaseId(),
-                                 index_data_key.ObjectStoreId(),
-                                 *primary_key_);
+  std::string primary_leveldb_key = ObjectStoreDataKey::Encode(
+      cursor_options_.database_id,
+      cursor_options_.object_store_id,
+      std::string(encoded_primary_key, slice.begin()));
 
   std::string result;
   bool found = false;
@@ -2324,30 +2352,27 @@ class IndexCursorImpl : public IndexedDBBackingStore::Cursor {
 
 bool IndexCursorImpl::LoadCurrentRow() {
   StringPiece slice(iterator_->Key());
-  IndexDataKey index_data_key;
-  if (!IndexDataKey::Decode(&slice, &index_data_key)) {
+  if (!DecodeCurrentKey(&slice)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  current_key_ = index_data_key.user_key();
-  DCHECK(current_key_);
-
   slice = StringPiece(iterator_->Value());
   int64 index_data_version;
   if (!DecodeVarInt(&slice, &index_data_version)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
+  const char* encoded_primary_key = slice.begin();
   if (!DecodeIDBKey(&slice, &primary_key_)) {
     INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
     return false;
   }
 
-  primary_leveldb_key_ =
-      ObjectStoreDataKey::Encode(index_data_key.DatabaseId(),
-                                 index_data_key.ObjectStoreId(),
-                                 *primary_key_);
+  primary_leveldb_key_ = ObjectStoreDataKey::Encode(
+      cursor_options_.database_id,
+      cursor_options_.object_store_id,
+      std::string(encoded_primary_key, slice.begin()));
 
   std::string result;
   bool found = false;
@@ -2377,7 +2402,10 @@ bool IndexCursorImpl::LoadCurrentRow() {
     return false;
   }
 
-  current_value_ = slice.as_string();
+  // Strip the version in place instead of copying the value a second time.
+  const size_t version_length = result.size() - slice.size();
+  current_value_.swap(result);
+  current_value_.erase(0, version_length);
   return true;
 }
 
@@ -2621,6 +2649,37 @@ IndexedDBBackingStore::OpenIndexCursor(
   return cursor.PassAs<IndexedDBBackingStore::Cursor>();
 }
 
+void IndexedDBBackingStore::AddToGroupCommit(
+    LevelDBTransaction* transaction,
+    const CommitCallback& callback) {
+  if (!group_commit_batch_) {
+    group_commit_batch_ = LevelDBWriteBatch::Create();
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&IndexedDBBackingStore::WriteGroupCommit, this));
+  }
+  transaction->CommitToWriteBatch(group_commit_batch_.get());
+  group_commit_callbacks_.push_back(callback);
+}
+
+void IndexedDBBackingStore::WriteGroupCommit() {
+  IDB_TRACE("IndexedDBBackingStore::WriteGroupCommit");
+  DCHECK(group_commit_batch_);
+  scoped_ptr<LevelDBWriteBatch> write_batch = group_commit_batch_.Pass();
+  std::vector<CommitCallback> callbacks;
+  callbacks.swap(group_commit_callbacks_);
+
+  // The batch is applied atomically, so either every transaction in the
+  // group is committed or none of them are.
+  leveldb::Status s = db_->Write(*write_batch);
+  if (!s.ok())
+    INTERNAL_WRITE_ERROR(TRANSACTION_COMMIT_METHOD);
+  UMA_HISTOGRAM_COUNTS_100("WebCore.IndexedDB.BackingStore.GroupCommitSize",
+                           callbacks.size());
+
+  for (size_t i = 0; i < callbacks.size(); ++i)
+    callbacks[i].Run(s);
+}
+
 IndexedDBBackingStore::Transaction::Transaction(
     IndexedDBBackingStore* backing_store)
     : backing_store_(backing_store) {}
@@ -2643,6 +2702,18 @@ leveldb::Status IndexedDBBackingStore::Transaction::Commit() {
   return s;
 }
 
+void IndexedDBBackingStore::Transaction::CommitAsync(
+    const CommitCallback& callback) {
+  if (!backing_store_ || !backing_store_->group_commit_enabled_) {
+    callback.Run(Commit());
+    return;
+  }
+  IDB_TRACE("IndexedDBBackingStore::Transaction::CommitAsync");
+  DCHECK(transaction_.get());
+  backing_store_->AddToGroupCommit(transaction_.get(), callback);
+  transaction_ = NULL;
+}
+
 void IndexedDBBackingStore::Transaction::Rollback() {
   IDB_TRACE("IndexedDBBackingStore::Transaction::Rollback");
   DCHECK(transaction_.get());
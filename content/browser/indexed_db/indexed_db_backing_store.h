@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -28,6 +29,7 @@ namespace content {
 
 class LevelDBComparator;
 class LevelDBDatabase;
+class LevelDBWriteBatch;
 
 class LevelDBFactory {
  public:
@@ -43,12 +45,20 @@ class CONTENT_EXPORT IndexedDBBackingStore
     : public base::RefCounted<IndexedDBBackingStore> {
  public:
   class CONTENT_EXPORT Transaction;
+  typedef base::Callback<void(const leveldb::Status&)> CommitCallback;
 
   const GURL& origin_url() const { return origin_url_; }
   base::OneShotTimer<IndexedDBBackingStore>* close_timer() {
     return &close_timer_;
   }
 
+  // When enabled, transactions committed with Transaction::CommitAsync()
+  // during the same task are written to LevelDB with a single synced write.
+  bool group_commit_enabled() const { return group_commit_enabled_; }
+  void set_group_commit_enabled(bool enabled) {
+    group_commit_enabled_ = enabled;
+  }
+
   static scoped_refptr<IndexedDBBackingStore> Open(
       const GURL& origin_url,
       const base::FilePath& path_base,
@@ -251,11 +261,24 @@ class CONTENT_EXPORT IndexedDBBackingStore
     bool IsPastBounds() const;
     bool HaveEnteredRange() const;
 
+    // Decodes the user key of the LevelDB key in |slice| into |current_key_|
+    // and advances |slice| past it. The key prefix shared by every row in
+    // the cursor's range is skipped rather than decoded, and the previous
+    // row's key is reused when the encoding has not changed.
+    bool DecodeCurrentKey(base::StringPiece* slice);
+    const std::string& current_encoded_key() const {
+      return current_encoded_key_;
+    }
+
     LevelDBTransaction* transaction_;
     const CursorOptions cursor_options_;
     scoped_ptr<LevelDBIterator> iterator_;
     scoped_ptr<IndexedDBKey> current_key_;
     IndexedDBBackingStore::RecordIdentifier record_identifier_;
+
+   private:
+    std::string encoded_key_prefix_;
+    std::string current_encoded_key_;
   };
 
   virtual scoped_ptr<Cursor> OpenObjectStoreKeyCursor(
@@ -291,6 +314,11 @@ class CONTENT_EXPORT IndexedDBBackingStore
     virtual ~Transaction();
     virtual void Begin();
     virtual leveldb::Status Commit();
+    // Like Commit(), but with group commit enabled the write is deferred
+    // until the end of the current task and shared with any other
+    // transactions committed before then. |callback| runs once the write has
+    // been synced, or synchronously if group commit is disabled.
+    void CommitAsync(const CommitCallback& callback);
     virtual void Rollback();
     void Reset() {
       backing_store_ = NULL;
@@ -330,6 +358,10 @@ class CONTENT_EXPORT IndexedDBBackingStore
                              IndexedDBObjectStoreMetadata::IndexMap* map)
       WARN_UNUSED_RESULT;
 
+  void AddToGroupCommit(LevelDBTransaction* transaction,
+                        const CommitCallback& callback);
+  void WriteGroupCommit();
+
   const GURL origin_url_;
 
   // The origin identifier is a key prefix unique to the origin used in the
@@ -343,6 +375,12 @@ class CONTENT_EXPORT IndexedDBBackingStore
   scoped_ptr<LevelDBDatabase> db_;
   scoped_ptr<LevelDBComparator> comparator_;
   base::OneShotTimer<IndexedDBBackingStore> close_timer_;
+
+  bool group_commit_enabled_;
+  // Writes of transactions waiting for the pending group commit, and the
+  // callbacks to run once they are on disk, in commit order.
+  scoped_ptr<LevelDBWriteBatch> group_commit_batch_;
+  std::vector<CommitCallback> group_commit_callbacks_;
 };
 
 }  // namespace content
@@ -4,7 +4,9 @@
 
 #include "content/browser/indexed_db/indexed_db_backing_store.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/browser/indexed_db/indexed_db_leveldb_coding.h"
@@ -34,6 +36,7 @@ class IndexedDBBackingStoreTest : public testing::Test {
   }
 
  protected:
+  base::MessageLoop message_loop_;
   scoped_refptr<IndexedDBBackingStore> backing_store_;
 
   // Sample keys and values that are consistent.
@@ -71,6 +74,125 @@ TEST_F(IndexedDBBackingStoreTest, PutGetConsistency) {
   }
 }
 
+void RecordCommitStatus(std::vector<leveldb::Status>* statuses,
+                        const leveldb::Status& status) {
+  statuses->push_back(status);
+}
+
+TEST_F(IndexedDBBackingStoreTest, GroupCommit) {
+  backing_store_->set_group_commit_enabled(true);
+  std::vector<leveldb::Status> statuses;
+
+  IndexedDBBackingStore::Transaction transaction1(backing_store_);
+  transaction1.Begin();
+  IndexedDBBackingStore::RecordIdentifier record;
+  leveldb::Status s = backing_store_->PutRecord(
+      &transaction1, 1, 1, m_key1, m_value1, &record);
+  EXPECT_TRUE(s.ok());
+
+  IndexedDBBackingStore::Transaction transaction2(backing_store_);
+  transaction2.Begin();
+  s = backing_store_->PutRecord(
+      &transaction2, 1, 2, m_key2, m_value2, &record);
+  EXPECT_TRUE(s.ok());
+
+  transaction1.CommitAsync(base::Bind(&RecordCommitStatus, &statuses));
+  transaction2.CommitAsync(base::Bind(&RecordCommitStatus, &statuses));
+
+  // Nothing is written until the shared write runs.
+  EXPECT_TRUE(statuses.empty());
+  {
+    IndexedDBBackingStore::Transaction transaction3(backing_store_);
+    transaction3.Begin();
+    std::string result_value;
+    s = backing_store_->GetRecord(&transaction3, 1, 1, m_key1, &result_value);
+    EXPECT_TRUE(s.ok());
+    EXPECT_TRUE(result_value.empty());
+    transaction3.Rollback();
+  }
+
+  message_loop_.RunUntilIdle();
+  ASSERT_EQ(2UL, statuses.size());
+  EXPECT_TRUE(statuses[0].ok());
+  EXPECT_TRUE(statuses[1].ok());
+
+  {
+    IndexedDBBackingStore::Transaction transaction4(backing_store_);
+    transaction4.Begin();
+    std::string result_value;
+    s = backing_store_->GetRecord(&transaction4, 1, 1, m_key1, &result_value);
+    EXPECT_TRUE(s.ok());
+    EXPECT_EQ(m_value1, result_value);
+    s = backing_store_->GetRecord(&transaction4, 1, 2, m_key2, &result_value);
+    EXPECT_TRUE(s.ok());
+    EXPECT_EQ(m_value2, result_value);
+    transaction4.Commit();
+  }
+}
+
+TEST_F(IndexedDBBackingStoreTest, IndexCursorWithDuplicateKeys) {
+  const int64 database_id = 1;
+  const int64 object_store_id = 1;
+  const int64 index_id = kMinimumIndexId;
+  const IndexedDBKey index_key(ASCIIToUTF16("duplicate"));
+
+  {
+    IndexedDBBackingStore::Transaction transaction1(backing_store_);
+    transaction1.Begin();
+    const IndexedDBKey* primary_keys[] = {&m_key1, &m_key2, &m_key3};
+    const std::string* values[] = {&m_value1, &m_value2, &m_value3};
+    for (size_t i = 0; i < arraysize(primary_keys); ++i) {
+      IndexedDBBackingStore::RecordIdentifier record;
+      leveldb::Status s = backing_store_->PutRecord(&transaction1,
+                                                    database_id,
+                                                    object_store_id,
+                                                    *primary_keys[i],
+                                                    *values[i],
+                                                    &record);
+      EXPECT_TRUE(s.ok());
+      s = backing_store_->PutIndexDataForRecord(&transaction1,
+                                                database_id,
+                                                object_store_id,
+                                                index_id,
+                                                index_key,
+                                                record);
+      EXPECT_TRUE(s.ok());
+    }
+    EXPECT_TRUE(transaction1.Commit().ok());
+  }
+
+  {
+    IndexedDBBackingStore::Transaction transaction2(backing_store_);
+    transaction2.Begin();
+    scoped_ptr<IndexedDBBackingStore::Cursor> cursor =
+        backing_store_->OpenIndexCursor(&transaction2,
+                                        database_id,
+                                        object_store_id,
+                                        index_id,
+                                        IndexedDBKeyRange(),
+                                        indexed_db::CURSOR_NEXT);
+    ASSERT_TRUE(cursor);
+
+    // Index entries with equal keys are ordered by primary key.
+    EXPECT_TRUE(cursor->key().IsEqual(index_key));
+    EXPECT_TRUE(cursor->primary_key().IsEqual(m_key1));
+    EXPECT_EQ(m_value1, *cursor->value());
+
+    ASSERT_TRUE(cursor->Continue());
+    EXPECT_TRUE(cursor->key().IsEqual(index_key));
+    EXPECT_TRUE(cursor->primary_key().IsEqual(m_key2));
+    EXPECT_EQ(m_value2, *cursor->value());
+
+    ASSERT_TRUE(cursor->Continue());
+    EXPECT_TRUE(cursor->key().IsEqual(index_key));
+    EXPECT_TRUE(cursor->primary_key().IsEqual(m_key3));
+    EXPECT_EQ(m_value3, *cursor->value());
+
+    EXPECT_FALSE(cursor->Continue());
+    transaction2.Commit();
+  }
+}
+
 // Make sure that using very high ( more than 32 bit ) values for database_id
 // and object_store_id still work.
 TEST_F(IndexedDBBackingStoreTest, HighIds) {
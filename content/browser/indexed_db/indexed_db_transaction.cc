@@ -228,16 +228,32 @@ void IndexedDBTransaction::Commit() {
   if (HasPendingTasks())
     return;
 
+  timeout_timer_.Stop();
+
+  state_ = FINISHED;
+
+  if (!used_) {
+    CommitPhaseTwo(leveldb::Status::OK());
+    return;
+  }
+
+  // With group commit the backing store may defer the write until the end of
+  // the current task. The transaction stays registered with the coordinator
+  // until then, so later transactions with an overlapping scope see the data.
+  transaction_->CommitAsync(
+      base::Bind(&IndexedDBTransaction::CommitPhaseTwo, this));
+}
+
+void IndexedDBTransaction::CommitPhaseTwo(const leveldb::Status& status) {
+  IDB_TRACE("IndexedDBTransaction::CommitPhaseTwo");
+  DCHECK_EQ(state_, FINISHED);
+
   // The last reference to this object may be released while performing the
   // commit steps below. We therefore take a self reference to keep ourselves
   // alive while executing this method.
   scoped_refptr<IndexedDBTransaction> protect(this);
 
-  timeout_timer_.Stop();
-
-  state_ = FINISHED;
-
-  bool committed = !used_ || transaction_->Commit().ok();
+  bool committed = status.ok();
 
   // Backing store resources (held via cursors) must be released
   // before script callbacks are fired, as the script callbacks may
@@ -94,6 +94,7 @@ class CONTENT_EXPORT IndexedDBTransaction
   bool HasPendingTasks() const;
 
   void ProcessTaskQueue();
+  void CommitPhaseTwo(const leveldb::Status& status);
   void CloseOpenCursors();
   void Timeout();
 
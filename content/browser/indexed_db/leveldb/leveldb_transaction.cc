@@ -94,14 +94,7 @@ leveldb::Status LevelDBTransaction::Commit() {
   }
 
   scoped_ptr<LevelDBWriteBatch> write_batch = LevelDBWriteBatch::Create();
-
-  for (DataType::iterator iterator = data_.begin(); iterator != data_.end();
-       ++iterator) {
-    if (!iterator->second->deleted)
-      write_batch->Put(iterator->first, iterator->second->value);
-    else
-      write_batch->Remove(iterator->first);
-  }
+  AppendToWriteBatch(write_batch.get());
 
   leveldb::Status s = db_->Write(*write_batch);
   if (s.ok()) {
@@ -111,6 +104,25 @@ leveldb::Status LevelDBTransaction::Commit() {
   return s;
 }
 
+void LevelDBTransaction::CommitToWriteBatch(LevelDBWriteBatch* write_batch) {
+  DCHECK(!finished_);
+  AppendToWriteBatch(write_batch);
+  Clear();
+  finished_ = true;
+}
+
+void LevelDBTransaction::AppendToWriteBatch(
+    LevelDBWriteBatch* write_batch) const {
+  for (DataType::const_iterator iterator = data_.begin();
+       iterator != data_.end();
+       ++iterator) {
+    if (!iterator->second->deleted)
+      write_batch->Put(iterator->first, iterator->second->value);
+    else
+      write_batch->Remove(iterator->first);
+  }
+}
+
 void LevelDBTransaction::Rollback() {
   DCHECK(!finished_);
   finished_ = true;
@@ -31,6 +31,9 @@ class CONTENT_EXPORT LevelDBTransaction
                       std::string* value,
                       bool* found);
   leveldb::Status Commit();
+  // Moves the pending changes into |write_batch| and finishes the
+  // transaction. The caller is responsible for writing the batch.
+  void CommitToWriteBatch(LevelDBWriteBatch* write_batch);
   void Rollback();
 
   scoped_ptr<LevelDBIterator> CreateIterator();
@@ -121,6 +124,7 @@ class CONTENT_EXPORT LevelDBTransaction
   };
 
   void Set(const base::StringPiece& key, std::string* value, bool deleted);
+  void AppendToWriteBatch(LevelDBWriteBatch* write_batch) const;
   void Clear();
   void RegisterIterator(TransactionIterator* iterator);
   void UnregisterIterator(TransactionIterator* iterator);
@@ -471,6 +471,10 @@ extern const char kEnableHTMLImports[]      = "enable-html-imports";
 // Enables support for inband text tracks in media content.
 const char kEnableInbandTextTracks[]        = "enable-inband-text-tracks";
 
+// Merges the commits of IndexedDB transactions that finish in the same task
+// into a single synced LevelDB write.
+const char kEnableIndexedDBGroupCommit[]    = "enable-indexeddb-group-commit";
+
 // Force logging to be enabled.  Logging is disabled by default in release
 // builds.
 const char kEnableLogging[]                 = "enable-logging";
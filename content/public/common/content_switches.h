@@ -142,6 +142,7 @@ CONTENT_EXPORT extern const char kEnableHighResolutionTime[];
 #endif
 CONTENT_EXPORT extern const char kEnableHTMLImports[];
 CONTENT_EXPORT extern const char kEnableInbandTextTracks[];
+CONTENT_EXPORT extern const char kEnableIndexedDBGroupCommit[];
 CONTENT_EXPORT extern const char kEnableLogging[];
 extern const char kEnableMemoryBenchmarking[];
 extern const char kEnableMonitorProfile[];
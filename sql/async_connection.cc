@@ -0,0 +1,131 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/async_connection.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
+#include "base/single_thread_task_runner.h"
+#include "base/thread_task_runner_handle.h"
+#include "sql/connection.h"
+#include "sql/transaction.h"
+
+namespace sql {
+
+AsyncConnection::PendingWrite::PendingWrite(
+    const WriteTask& task,
+    const StatusCallback& callback,
+    const scoped_refptr<base::SingleThreadTaskRunner>& origin)
+    : task(task), callback(callback), origin(origin) {
+}
+
+AsyncConnection::PendingWrite::~PendingWrite() {
+}
+
+AsyncConnection::AsyncConnection(
+    scoped_ptr<Connection> db,
+    const base::FilePath& path,
+    const scoped_refptr<base::SequencedTaskRunner>& write_task_runner,
+    const scoped_refptr<base::SequencedTaskRunner>& read_task_runner)
+    : path_(path),
+      write_task_runner_(write_task_runner),
+      read_task_runner_(read_task_runner),
+      db_(db.Pass()) {
+  DCHECK(write_task_runner_.get());
+  // Without WAL a reader would block on, and block, the writer.
+  DCHECK(!read_task_runner_.get() || db_->wal_mode());
+}
+
+AsyncConnection::~AsyncConnection() {
+  // No tasks can be pending at this point, as they hold references to this
+  // object, but each connection must be closed on its own sequence.
+  if (db_)
+    write_task_runner_->DeleteSoon(FROM_HERE, db_.release());
+  if (read_db_)
+    read_task_runner_->DeleteSoon(FROM_HERE, read_db_.release());
+}
+
+void AsyncConnection::Open(const StatusCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      write_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&AsyncConnection::OpenOnWriteSequence, this),
+      callback);
+}
+
+void AsyncConnection::Write(const WriteTask& task,
+                            const StatusCallback& callback) {
+  base::AutoLock lock(lock_);
+  pending_writes_.push_back(
+      PendingWrite(task, callback, base::ThreadTaskRunnerHandle::Get()));
+
+  // The first write queued after a commit schedules the next one; later
+  // writes ride along with it.
+  if (pending_writes_.size() == 1) {
+    write_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&AsyncConnection::CommitPendingWrites, this));
+  }
+}
+
+base::SequencedTaskRunner* AsyncConnection::read_task_runner() const {
+  return read_task_runner_.get() ? read_task_runner_.get()
+                                 : write_task_runner_.get();
+}
+
+Connection* AsyncConnection::GetReadConnection() {
+  if (!read_task_runner_.get()) {
+    DCHECK(write_task_runner_->RunsTasksOnCurrentThread());
+    return db_.get();
+  }
+
+  DCHECK(read_task_runner_->RunsTasksOnCurrentThread());
+  if (!read_db_) {
+    read_db_.reset(new Connection);
+    // Opening with any other journal mode would try to take the database
+    // out of WAL mode.
+    read_db_->set_wal_mode(0);
+    if (!read_db_->Open(path_))
+      DLOG(ERROR) << "Could not open read connection";
+  }
+  return read_db_.get();
+}
+
+bool AsyncConnection::OpenOnWriteSequence() {
+  return db_->Open(path_);
+}
+
+void AsyncConnection::CommitPendingWrites() {
+  std::vector<PendingWrite> writes;
+  {
+    base::AutoLock lock(lock_);
+    writes.swap(pending_writes_);
+  }
+  DCHECK(!writes.empty());
+  UMA_HISTOGRAM_COUNTS_100("Sqlite.AsyncConnection.WritesPerCommit",
+                           writes.size());
+
+  std::vector<bool> results(writes.size(), false);
+  bool committed = false;
+  Transaction transaction(db_.get());
+  if (transaction.Begin()) {
+    for (size_t i = 0; i < writes.size(); ++i) {
+      if (!db_->Execute("SAVEPOINT async_write"))
+        continue;
+      results[i] = writes[i].task.Run(db_.get());
+      if (!results[i])
+        ignore_result(db_->Execute("ROLLBACK TO async_write"));
+      ignore_result(db_->Execute("RELEASE async_write"));
+    }
+    committed = transaction.Commit();
+  }
+
+  for (size_t i = 0; i < writes.size(); ++i) {
+    writes[i].origin->PostTask(
+        FROM_HERE, base::Bind(writes[i].callback, committed && results[i]));
+  }
+}
+
+}  // namespace sql
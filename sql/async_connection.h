@@ -0,0 +1,146 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SQL_ASYNC_CONNECTION_H_
+#define SQL_ASYNC_CONNECTION_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "sql/sql_export.h"
+
+namespace base {
+class SequencedTaskRunner;
+class SingleThreadTaskRunner;
+}
+
+namespace sql {
+
+class Connection;
+
+// Runs work against a sql::Connection on a database sequence and reports
+// the results back to the calling thread, replacing the "post to the DB
+// thread, run statements, post a reply" plumbing each client would
+// otherwise write.
+//
+// Writes are queued, and all writes queued by the time the database
+// sequence gets to them are committed in a single transaction, each inside
+// its own savepoint so that a failing write does not take the others down
+// with it.  A write's callback runs once the shared transaction committed.
+//
+// Reads run on |write_task_runner| behind any queued writes, unless a
+// |read_task_runner| is supplied.  In that case the database must use
+// Connection::set_wal_mode(), and reads run against a second connection on
+// the read sequence which sees the last committed state of the database
+// without waiting for writes in progress.  A read therefore may not see
+// writes which have been queued but whose callbacks have not yet run.
+//
+// Example:
+//   scoped_ptr<sql::Connection> db(new sql::Connection);
+//   db->set_wal_mode(1000);
+//   async_db_ = new sql::AsyncConnection(db.Pass(), path, db_runner,
+//                                        read_runner);
+//   async_db_->Open(base::Bind(&Foo::OnOpened, weak_factory_.GetWeakPtr()));
+//   ...
+//   async_db_->Read<int>(base::Bind(&CountRows),
+//                        base::Bind(&Foo::OnCount, weak_ptr));
+class SQL_EXPORT AsyncConnection
+    : public base::RefCountedThreadSafe<AsyncConnection> {
+ public:
+  // Runs a write on the database sequence and returns whether it
+  // succeeded.  Writes should report failure by returning false rather
+  // than by rolling back a nested sql::Transaction, which would roll back
+  // every write committed with it.
+  typedef base::Callback<bool(Connection*)> WriteTask;
+  typedef base::Callback<void(bool)> StatusCallback;
+
+  // |db| holds the pre-Open() configuration for the database at |path|,
+  // and is opened and used only on |write_task_runner|.  |read_task_runner|
+  // may be NULL, see above.
+  AsyncConnection(scoped_ptr<Connection> db,
+                  const base::FilePath& path,
+                  const scoped_refptr<base::SequencedTaskRunner>&
+                      write_task_runner,
+                  const scoped_refptr<base::SequencedTaskRunner>&
+                      read_task_runner);
+
+  // Opens the database, then runs |callback| with the result.  Reads and
+  // writes should not be issued before |callback| runs.
+  void Open(const StatusCallback& callback);
+
+  // Runs |task| on the database sequence as part of the next batch of
+  // writes, and |callback| once the batch has committed.  |callback| is
+  // passed false if |task| failed or the batch could not be committed.
+  void Write(const WriteTask& task, const StatusCallback& callback);
+
+  // Runs |task| on the read sequence and passes its result to |reply| on
+  // the calling thread.
+  template <typename ReturnType>
+  void Read(const base::Callback<ReturnType(Connection*)>& task,
+            const base::Callback<void(ReturnType)>& reply) {
+    base::PostTaskAndReplyWithResult(
+        read_task_runner(),
+        FROM_HERE,
+        base::Bind(&AsyncConnection::RunRead<ReturnType>, this, task),
+        reply);
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<AsyncConnection>;
+
+  struct PendingWrite {
+    PendingWrite(const WriteTask& task,
+                 const StatusCallback& callback,
+                 const scoped_refptr<base::SingleThreadTaskRunner>& origin);
+    ~PendingWrite();
+
+    WriteTask task;
+    StatusCallback callback;
+    scoped_refptr<base::SingleThreadTaskRunner> origin;
+  };
+
+  ~AsyncConnection();
+
+  base::SequencedTaskRunner* read_task_runner() const;
+
+  // Returns the connection reads use on the current sequence, opening the
+  // read connection the first time it is needed.
+  Connection* GetReadConnection();
+
+  template <typename ReturnType>
+  ReturnType RunRead(const base::Callback<ReturnType(Connection*)>& task) {
+    return task.Run(GetReadConnection());
+  }
+
+  bool OpenOnWriteSequence();
+  void CommitPendingWrites();
+
+  const base::FilePath path_;
+  const scoped_refptr<base::SequencedTaskRunner> write_task_runner_;
+  const scoped_refptr<base::SequencedTaskRunner> read_task_runner_;
+
+  // Used only on |write_task_runner_|.
+  scoped_ptr<Connection> db_;
+
+  // Used only on |read_task_runner_|.
+  scoped_ptr<Connection> read_db_;
+
+  // Protects |pending_writes_|, which is appended to on the calling threads
+  // and drained on the database sequence.
+  base::Lock lock_;
+  std::vector<PendingWrite> pending_writes_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncConnection);
+};
+
+}  // namespace sql
+
+#endif  // SQL_ASYNC_CONNECTION_H_
@@ -0,0 +1,130 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/async_connection.h"
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/run_loop.h"
+#include "base/threading/thread.h"
+#include "sql/connection.h"
+#include "sql/statement.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+bool CreateTable(sql::Connection* db) {
+  return db->Execute("CREATE TABLE foo (a INTEGER)");
+}
+
+bool InsertRow(int value, sql::Connection* db) {
+  sql::Statement s(db->GetUniqueStatement("INSERT INTO foo (a) VALUES (?)"));
+  s.BindInt(0, value);
+  return s.Run();
+}
+
+bool InsertRowAndFail(int value, sql::Connection* db) {
+  InsertRow(value, db);
+  return false;
+}
+
+int CountRows(sql::Connection* db) {
+  sql::Statement s(db->GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  return s.Step() ? s.ColumnInt(0) : -1;
+}
+
+void SaveStatus(std::vector<bool>* results, bool result) {
+  results->push_back(result);
+}
+
+void SaveCount(int* count, base::RunLoop* run_loop, int result) {
+  *count = result;
+  run_loop->Quit();
+}
+
+class SQLAsyncConnectionTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_path_ = temp_dir_.path().AppendASCII("SQLAsyncConnectionTest.db");
+  }
+
+  const base::FilePath& db_path() const { return db_path_; }
+
+ protected:
+  base::MessageLoop message_loop_;
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  base::FilePath db_path_;
+};
+
+TEST_F(SQLAsyncConnectionTest, BatchedWrites) {
+  scoped_refptr<sql::AsyncConnection> db(new sql::AsyncConnection(
+      make_scoped_ptr(new sql::Connection), db_path(),
+      base::MessageLoopProxy::current(), NULL));
+
+  std::vector<bool> results;
+  db->Open(base::Bind(&SaveStatus, &results));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(1u, results.size());
+  ASSERT_TRUE(results[0]);
+  results.clear();
+
+  // All four writes are committed together, but the failing one is rolled
+  // back on its own.
+  db->Write(base::Bind(&CreateTable), base::Bind(&SaveStatus, &results));
+  db->Write(base::Bind(&InsertRow, 1), base::Bind(&SaveStatus, &results));
+  db->Write(base::Bind(&InsertRowAndFail, 2),
+            base::Bind(&SaveStatus, &results));
+  db->Write(base::Bind(&InsertRow, 3), base::Bind(&SaveStatus, &results));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(4u, results.size());
+  EXPECT_TRUE(results[0]);
+  EXPECT_TRUE(results[1]);
+  EXPECT_FALSE(results[2]);
+  EXPECT_TRUE(results[3]);
+
+  int count = 0;
+  base::RunLoop run_loop;
+  db->Read<int>(base::Bind(&CountRows),
+                base::Bind(&SaveCount, &count, &run_loop));
+  run_loop.Run();
+  EXPECT_EQ(2, count);
+}
+
+TEST_F(SQLAsyncConnectionTest, ReadsOnReadSequence) {
+  base::Thread read_thread("SQLAsyncConnectionTest read thread");
+  ASSERT_TRUE(read_thread.Start());
+
+  scoped_ptr<sql::Connection> connection(new sql::Connection);
+  connection->set_wal_mode(0);
+  scoped_refptr<sql::AsyncConnection> db(new sql::AsyncConnection(
+      connection.Pass(), db_path(), base::MessageLoopProxy::current(),
+      read_thread.message_loop_proxy()));
+
+  std::vector<bool> results;
+  db->Open(base::Bind(&SaveStatus, &results));
+  db->Write(base::Bind(&CreateTable), base::Bind(&SaveStatus, &results));
+  db->Write(base::Bind(&InsertRow, 1), base::Bind(&SaveStatus, &results));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(3u, results.size());
+  EXPECT_TRUE(results[2]);
+
+  int count = 0;
+  base::RunLoop run_loop;
+  db->Read<int>(base::Bind(&CountRows),
+                base::Bind(&SaveCount, &count, &run_loop));
+  run_loop.Run();
+  EXPECT_EQ(1, count);
+
+  // The read connection is closed on the read thread.
+  db = NULL;
+  read_thread.Stop();
+}
+
+}  // namespace
@@ -216,6 +216,12 @@ Connection::Connection()
       cache_size_(0),
       exclusive_locking_(false),
       restrict_to_user_(false),
+      wal_mode_(false),
+      wal_autocheckpoint_pages_(0),
+      statement_cache_(CachedStatementMap::NO_AUTO_EVICT),
+      statement_cache_limit_(0),
+      statement_cache_hits_(0),
+      statement_cache_misses_(0),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
@@ -265,8 +271,16 @@ void Connection::CloseInternal(bool forced) {
 
   // sqlite3_close() needs all prepared statements to be finalized.
 
+  // Report how well the statement cache worked for this connection.
+  const size_t lookups = statement_cache_hits_ + statement_cache_misses_;
+  if (lookups)
+    AddTaggedHistogram("Sqlite.StatementCacheHitRate",
+                       statement_cache_hits_ * 100 / lookups);
+  statement_cache_hits_ = 0;
+  statement_cache_misses_ = 0;
+
   // Release cached statements.
-  statement_cache_.clear();
+  statement_cache_.Clear();
 
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
@@ -552,16 +566,37 @@ bool Connection::Delete(const base::FilePath& path) {
 
   base::FilePath journal_path(path.value() + FILE_PATH_LITERAL("-journal"));
   base::FilePath wal_path(path.value() + FILE_PATH_LITERAL("-wal"));
+  base::FilePath shm_path(path.value() + FILE_PATH_LITERAL("-shm"));
 
   base::DeleteFile(journal_path, false);
   base::DeleteFile(wal_path, false);
+  base::DeleteFile(shm_path, false);
   base::DeleteFile(path, false);
 
   return !base::PathExists(journal_path) &&
       !base::PathExists(wal_path) &&
+      !base::PathExists(shm_path) &&
       !base::PathExists(path);
 }
 
+bool Connection::CheckpointWAL() {
+  AssertIOAllowed();
+
+  if (!db_) {
+    DLOG_IF(FATAL, !poisoned_) << "Cannot checkpoint null db";
+    return false;
+  }
+  DCHECK(wal_mode_);
+
+  int rc = sqlite3_wal_checkpoint_v2(
+      db_, NULL, SQLITE_CHECKPOINT_PASSIVE, NULL, NULL);
+  if (rc != SQLITE_OK) {
+    OnSqliteError(rc, NULL, "-- sqlite3_wal_checkpoint_v2()");
+    return false;
+  }
+  return true;
+}
+
 bool Connection::BeginTransaction() {
   if (needs_rollback_) {
     DCHECK_GT(transaction_nesting_, 0);
@@ -690,13 +725,13 @@ bool Connection::ExecuteWithTimeout(const char* sql, base::TimeDelta timeout) {
 }
 
 bool Connection::HasCachedStatement(const StatementID& id) const {
-  return statement_cache_.find(id) != statement_cache_.end();
+  return statement_cache_.Peek(id) != statement_cache_.end();
 }
 
 scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     const StatementID& id,
     const char* sql) {
-  CachedStatementMap::iterator i = statement_cache_.find(id);
+  CachedStatementMap::iterator i = statement_cache_.Get(id);
   if (i != statement_cache_.end()) {
     // Statement is in the cache. It should still be active (we're the only
     // one invalidating cached statements, and we'll remove it from the cache
@@ -704,12 +739,19 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     // case it still has some stuff bound.
     DCHECK(i->second->is_valid());
     sqlite3_reset(i->second->stmt());
+    ++statement_cache_hits_;
     return i->second;
   }
 
+  ++statement_cache_misses_;
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
-    statement_cache_[id] = statement;  // Only cache valid statements.
+  if (statement->is_valid()) {
+    // Only cache valid statements.  Evicted statements which are still
+    // in use stay alive until the caller's Statement releases them.
+    statement_cache_.Put(id, statement);
+    if (statement_cache_limit_)
+      statement_cache_.ShrinkToSize(statement_cache_limit_);
+  }
   return statement;
 }
 
@@ -917,8 +959,10 @@ bool Connection::OpenInternal(const std::string& file_name,
       // be fatal unless the file doesn't exist.
       base::FilePath journal_path(file_name + FILE_PATH_LITERAL("-journal"));
       base::FilePath wal_path(file_name + FILE_PATH_LITERAL("-wal"));
+      base::FilePath shm_path(file_name + FILE_PATH_LITERAL("-shm"));
       base::SetPosixFilePermissions(journal_path, mode);
       base::SetPosixFilePermissions(wal_path, mode);
+      base::SetPosixFilePermissions(shm_path, mode);
     }
   }
 #endif  // defined(OS_POSIX)
@@ -977,7 +1021,17 @@ bool Connection::OpenInternal(const std::string& file_name,
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  // WAL - append to -wal file to commit, see set_wal_mode().
+  // journal_size_limit also bounds the -wal file left after a
+  // checkpoint.
+  if (wal_mode_ && !in_memory_) {
+    ignore_result(Execute("PRAGMA journal_mode = WAL"));
+    const std::string sql = base::StringPrintf(
+        "PRAGMA wal_autocheckpoint=%d", wal_autocheckpoint_pages_);
+    ignore_result(Execute(sql.c_str()));
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  }
   ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
 
   const base::TimeDelta kBusyTimeout =
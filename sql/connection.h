@@ -13,6 +13,7 @@
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/thread_restrictions.h"
@@ -117,6 +118,29 @@ class SQL_EXPORT Connection {
   // This must be called before Open() to have an effect.
   void set_exclusive_locking() { exclusive_locking_ = true; }
 
+  // Call to use SQLite's write-ahead log instead of the default
+  // rollback journal.  Readers no longer block the writer and commits
+  // only sync the -wal file, at the cost of -wal and -shm files living
+  // next to the database.  The log is copied back into the database
+  // (checkpointed) by the commit which grows it past
+  // |autocheckpoint_pages|; pass 0 to disable automatic checkpoints
+  // and call CheckpointWAL() on the database sequence at a time of the
+  // caller's choosing instead.  Has no effect on in-memory databases.
+  //
+  // This must be called before Open() to have an effect.
+  void set_wal_mode(int autocheckpoint_pages) {
+    wal_mode_ = true;
+    wal_autocheckpoint_pages_ = autocheckpoint_pages;
+  }
+  bool wal_mode() const { return wal_mode_; }
+
+  // Bounds the statement cache to |limit| statements, finalizing the
+  // least recently used statement when a new one would exceed it.  By
+  // default the cache is unbounded.
+  void set_statement_cache_limit(size_t limit) {
+    statement_cache_limit_ = limit;
+  }
+
   // Call to cause Open() to restrict access permissions of the
   // database file to only the owner.
   // TODO(shess): Currently only supported on OS_POSIX, is a noop on
@@ -206,6 +230,11 @@ class SQL_EXPORT Connection {
   // usage by half.
   void TrimMemory(bool aggressively);
 
+  // Copies committed pages from the write-ahead log back into the
+  // database without blocking readers or writers, for connections
+  // opened with set_wal_mode().  Returns true on success.
+  bool CheckpointWAL();
+
   // Raze the database to the ground.  This approximates creating a
   // fresh database from scratch, within the constraints of SQLite's
   // locking protocol (locks and open handles can make doing this with
@@ -348,6 +377,11 @@ class SQL_EXPORT Connection {
   scoped_refptr<StatementRef> GetCachedStatement(const StatementID& id,
                                                  const char* sql);
 
+  // Number of GetCachedStatement() calls which found, respectively
+  // did not find, the statement in the cache since Open().
+  size_t statement_cache_hits() const { return statement_cache_hits_; }
+  size_t statement_cache_misses() const { return statement_cache_misses_; }
+
   // Used to check a |sql| statement for syntactic validity. If the statement is
   // valid SQL, returns true.
   bool IsSQLValid(const char* sql);
@@ -557,12 +591,17 @@ class SQL_EXPORT Connection {
   int cache_size_;
   bool exclusive_locking_;
   bool restrict_to_user_;
+  bool wal_mode_;
+  int wal_autocheckpoint_pages_;
 
-  // All cached statements. Keeping a reference to these statements means that
-  // they'll remain active.
-  typedef std::map<StatementID, scoped_refptr<StatementRef> >
+  // All cached statements, most recently used first. Keeping a reference to
+  // these statements means that they'll remain active.
+  typedef base::MRUCache<StatementID, scoped_refptr<StatementRef> >
       CachedStatementMap;
   CachedStatementMap statement_cache_;
+  size_t statement_cache_limit_;
+  size_t statement_cache_hits_;
+  size_t statement_cache_misses_;
 
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
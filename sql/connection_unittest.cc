@@ -167,6 +167,72 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, CachedStatementLimit) {
+  sql::StatementID id1("foo", 1);
+  sql::StatementID id2("foo", 2);
+  sql::StatementID id3("foo", 3);
+
+  db().Close();
+  db().set_statement_cache_limit(2);
+  ASSERT_TRUE(db().Open(db_path()));
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  {
+    sql::Statement s1(db().GetCachedStatement(id1, "SELECT a FROM foo"));
+    sql::Statement s2(db().GetCachedStatement(id2, "SELECT b FROM foo"));
+    ASSERT_TRUE(s1.is_valid());
+    ASSERT_TRUE(s2.is_valid());
+  }
+  EXPECT_EQ(0u, db().statement_cache_hits());
+  EXPECT_EQ(2u, db().statement_cache_misses());
+
+  // Using |id1| makes |id2| the least recently used statement, so it is the
+  // one dropped when |id3| is added.
+  {
+    sql::Statement s1(db().GetCachedStatement(id1, "SELECT a FROM foo"));
+    ASSERT_TRUE(s1.is_valid());
+    sql::Statement s3(db().GetCachedStatement(id3, "SELECT * FROM foo"));
+    ASSERT_TRUE(s3.is_valid());
+  }
+  EXPECT_EQ(1u, db().statement_cache_hits());
+  EXPECT_EQ(3u, db().statement_cache_misses());
+  EXPECT_TRUE(db().HasCachedStatement(id1));
+  EXPECT_FALSE(db().HasCachedStatement(id2));
+  EXPECT_TRUE(db().HasCachedStatement(id3));
+}
+
+TEST_F(SQLConnectionTest, WALMode) {
+  db().Close();
+  db().set_wal_mode(0);
+  ASSERT_TRUE(db().Open(db_path()));
+
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a, b) VALUES (1, 2)"));
+
+  // With automatic checkpoints disabled the commits stay in the log until
+  // they are explicitly checkpointed.
+  base::FilePath wal(db_path().value() + FILE_PATH_LITERAL("-wal"));
+  EXPECT_TRUE(base::PathExists(wal));
+  EXPECT_TRUE(db().CheckpointWAL());
+
+  {
+    sql::Statement s(db().GetUniqueStatement("SELECT b FROM foo"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ(2, s.ColumnInt(0));
+  }
+
+  db().Close();
+  sql::Connection::Delete(db_path());
+  EXPECT_FALSE(base::PathExists(db_path()));
+  EXPECT_FALSE(base::PathExists(wal));
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
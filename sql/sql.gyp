@@ -20,6 +20,8 @@
       ],
       'defines': [ 'SQL_IMPLEMENTATION' ],
       'sources': [
+        'async_connection.cc',
+        'async_connection.h',
         'connection.cc',
         'connection.h',
         'error_delegate_util.cc',
@@ -86,6 +88,7 @@
         '../third_party/sqlite/sqlite.gyp:sqlite',
       ],
       'sources': [
+        'async_connection_unittest.cc',
         'connection_unittest.cc',
         'meta_table_unittest.cc',
         'recovery_unittest.cc',
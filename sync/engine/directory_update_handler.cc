@@ -10,12 +10,22 @@
 #include "sync/sessions/status_controller.h"
 #include "sync/syncable/directory.h"
 #include "sync/syncable/syncable_model_neutral_write_transaction.h"
+#include "sync/syncable/syncable_read_transaction.h"
 #include "sync/syncable/syncable_write_transaction.h"
 
 namespace syncer {
 
 using syncable::SYNCER;
 
+namespace {
+
+// A large download is applied in transactions of at most this many updates,
+// each a separate task on the model's thread, so that the model's own tasks
+// can run in between.
+const size_t kMaxUpdatesPerTransaction = 500;
+
+}  // namespace
+
 DirectoryUpdateHandler::DirectoryUpdateHandler(
     syncable::Directory* dir,
     ModelType type,
@@ -46,13 +56,8 @@ void DirectoryUpdateHandler::ApplyUpdates(sessions::StatusController* status) {
   }
 
   // This will invoke handlers that belong to the model and its thread, so we
-  // switch to the appropriate thread before we start this work.
-  WorkCallback c = base::Bind(
-      &DirectoryUpdateHandler::ApplyUpdatesImpl,
-      // We wait until the callback is executed.  We can safely use Unretained.
-      base::Unretained(this),
-      base::Unretained(status));
-  worker_->DoWorkAndWaitUntilDone(c);
+  // switch to the appropriate thread for each part of this work.
+  ApplyUpdatesImpl(worker_.get(), status);
 }
 
 void DirectoryUpdateHandler::PassiveApplyUpdates(
@@ -62,76 +67,102 @@ void DirectoryUpdateHandler::PassiveApplyUpdates(
   }
 
   // Just do the work here instead of deferring to another thread.
-  ApplyUpdatesImpl(status);
+  ApplyUpdatesImpl(NULL, status);
 }
 
 SyncerError DirectoryUpdateHandler::ApplyUpdatesImpl(
+    ModelSafeWorker* worker,
     sessions::StatusController* status) {
-  syncable::WriteTransaction trans(FROM_HERE, syncable::SYNCER, dir_);
-
   std::vector<int64> handles;
-  dir_->GetUnappliedUpdateMetaHandles(
-      &trans,
-      FullModelTypeSet(type_),
-      &handles);
+  Cryptographer* cryptographer = NULL;
+  {
+    syncable::ReadTransaction trans(FROM_HERE, dir_);
+    dir_->GetUnappliedUpdateMetaHandles(
+        &trans,
+        FullModelTypeSet(type_),
+        &handles);
+    cryptographer = dir_->GetCryptographer(&trans);
+  }
 
   // First set of update application passes.
-  UpdateApplicator applicator(dir_->GetCryptographer(&trans));
-  applicator.AttemptApplications(&trans, handles);
+  UpdateApplicator applicator(cryptographer);
+  SyncerError result = applicator.AttemptApplicationsInSlices(
+      dir_, worker, handles, kMaxUpdatesPerTransaction);
   status->increment_num_updates_applied_by(applicator.updates_applied());
   status->increment_num_hierarchy_conflicts_by(
       applicator.hierarchy_conflicts());
   status->increment_num_encryption_conflicts_by(
       applicator.encryption_conflicts());
+  if (result != SYNCER_OK)
+    return result;
 
   if (applicator.simple_conflict_ids().size() != 0) {
-    // Resolve the simple conflicts we just detected.
-    ConflictResolver resolver;
-    resolver.ResolveConflicts(&trans,
-                              dir_->GetCryptographer(&trans),
-                              applicator.simple_conflict_ids(),
-                              status);
-
-    // Conflict resolution sometimes results in more updates to apply.
-    handles.clear();
-    dir_->GetUnappliedUpdateMetaHandles(
-        &trans,
-        FullModelTypeSet(type_),
-        &handles);
-
-    UpdateApplicator conflict_applicator(dir_->GetCryptographer(&trans));
-    conflict_applicator.AttemptApplications(&trans, handles);
-
-    // We count the number of updates from both applicator passes.
-    status->increment_num_updates_applied_by(
-        conflict_applicator.updates_applied());
-
-    // Encryption conflicts should remain unchanged by the resolution of simple
-    // conflicts.  Those can only be solved by updating our nigori key bag.
-    DCHECK_EQ(conflict_applicator.encryption_conflicts(),
-              applicator.encryption_conflicts());
-
-    // Hierarchy conflicts should also remain unchanged, for reasons that are
-    // more subtle.  Hierarchy conflicts exist when the application of a pending
-    // update from the server would make the local folder hierarchy
-    // inconsistent.  The resolution of simple conflicts could never affect the
-    // hierarchy conflicting item directly, because hierarchy conflicts are not
-    // processed by the conflict resolver.  It could, in theory, modify the
-    // local hierarchy on which hierarchy conflict detection depends.  However,
-    // the conflict resolution algorithm currently in use does not allow this.
-    DCHECK_EQ(conflict_applicator.hierarchy_conflicts(),
-              applicator.hierarchy_conflicts());
-
-    // There should be no simple conflicts remaining.  We know this because the
-    // resolver should have resolved all the conflicts we detected last time
-    // and, by the two previous assertions, that no conflicts have been
-    // downgraded from encryption or hierarchy down to simple.
-    DCHECK(conflict_applicator.simple_conflict_ids().empty());
+    // Conflicts are rare, so resolving them and applying the result is kept
+    // in a single transaction.
+    WorkCallback c = base::Bind(
+        &DirectoryUpdateHandler::ResolveConflictsAndReapply,
+        // We wait until the callback is executed.  We can safely use
+        // Unretained.
+        base::Unretained(this),
+        base::Unretained(&applicator),
+        base::Unretained(status));
+    return worker ? worker->DoWorkAndWaitUntilDone(c) : c.Run();
   }
 
   return SYNCER_OK;
 }
 
+SyncerError DirectoryUpdateHandler::ResolveConflictsAndReapply(
+    UpdateApplicator* applicator,
+    sessions::StatusController* status) {
+  syncable::WriteTransaction trans(FROM_HERE, syncable::SYNCER, dir_);
+
+  // Resolve the simple conflicts we just detected.
+  ConflictResolver resolver;
+  resolver.ResolveConflicts(&trans,
+                            dir_->GetCryptographer(&trans),
+                            applicator->simple_conflict_ids(),
+                            status);
+
+  // Conflict resolution sometimes results in more updates to apply.
+  std::vector<int64> handles;
+  dir_->GetUnappliedUpdateMetaHandles(
+      &trans,
+      FullModelTypeSet(type_),
+      &handles);
+
+  UpdateApplicator conflict_applicator(dir_->GetCryptographer(&trans));
+  conflict_applicator.AttemptApplications(&trans, handles);
+
+  // We count the number of updates from both applicator passes.
+  status->increment_num_updates_applied_by(
+      conflict_applicator.updates_applied());
+
+  // Encryption conflicts should remain unchanged by the resolution of simple
+  // conflicts.  Those can only be solved by updating our nigori key bag.
+  DCHECK_EQ(conflict_applicator.encryption_conflicts(),
+            applicator->encryption_conflicts());
+
+  // Hierarchy conflicts should also remain unchanged, for reasons that are
+  // more subtle.  Hierarchy conflicts exist when the application of a pending
+  // update from the server would make the local folder hierarchy
+  // inconsistent.  The resolution of simple conflicts could never affect the
+  // hierarchy conflicting item directly, because hierarchy conflicts are not
+  // processed by the conflict resolver.  It could, in theory, modify the
+  // local hierarchy on which hierarchy conflict detection depends.  However,
+  // the conflict resolution algorithm currently in use does not allow this.
+  DCHECK_EQ(conflict_applicator.hierarchy_conflicts(),
+            applicator->hierarchy_conflicts());
+
+  // There should be no simple conflicts remaining.  We know this because the
+  // resolver should have resolved all the conflicts we detected last time
+  // and, by the two previous assertions, that no conflicts have been
+  // downgraded from encryption or hierarchy down to simple.
+  DCHECK(conflict_applicator.simple_conflict_ids().empty());
+
+  return SYNCER_OK;
+}
+
 bool DirectoryUpdateHandler::IsApplyUpdatesRequired() {
   if (IsControlType(type_)) {
     return false;  // We don't process control types here.
@@ -31,6 +31,7 @@ class Directory;
 }
 
 class ModelSafeWorker;
+class UpdateApplicator;
 
 // This class represents the syncable::Directory's processes for requesting and
 // processing updates from the sync server.
@@ -87,8 +88,16 @@ class SYNC_EXPORT_PRIVATE DirectoryUpdateHandler : public UpdateHandler {
   void UpdateProgressMarker(
       const sync_pb::DataTypeProgressMarker& progress_marker);
 
-  // Skips all checks and goes straight to applying the updates.
-  SyncerError ApplyUpdatesImpl(sessions::StatusController* status);
+  // Skips all checks and goes straight to applying the updates.  Each
+  // transaction is run as a separate work item on |worker|, or directly if
+  // |worker| is NULL.
+  SyncerError ApplyUpdatesImpl(ModelSafeWorker* worker,
+                               sessions::StatusController* status);
+
+  // Resolves the simple conflicts found by |applicator| and applies the
+  // updates that resolution leaves, in a single transaction.
+  SyncerError ResolveConflictsAndReapply(UpdateApplicator* applicator,
+                                         sessions::StatusController* status);
 
   syncable::Directory* dir_;
   ModelType type_;
@@ -8,6 +8,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/stl_util.h"
 #include "sync/engine/syncer_proto_util.h"
+#include "sync/engine/update_applicator.h"
 #include "sync/internal_api/public/base/model_type.h"
 #include "sync/internal_api/public/test/test_entry_factory.h"
 #include "sync/protocol/sync.pb.h"
@@ -311,6 +312,32 @@ sync_pb::EntitySpecifics DefaultBookmarkSpecifics() {
   AddDefaultFieldValue(BOOKMARKS, &result);
   return result;
 }
+
+// Does work on the current thread, counting the work items it was given.
+class CountingModelWorker : public ModelSafeWorker {
+ public:
+  CountingModelWorker() : ModelSafeWorker(NULL), work_count_(0) {}
+
+  // ModelSafeWorker implementation.
+  virtual void RegisterForLoopDestruction() OVERRIDE {}
+  virtual ModelSafeGroup GetModelSafeGroup() OVERRIDE { return GROUP_UI; }
+
+  int work_count() const { return work_count_; }
+
+ protected:
+  virtual SyncerError DoWorkAndWaitUntilDoneImpl(
+      const WorkCallback& work) OVERRIDE {
+    ++work_count_;
+    return work.Run();
+  }
+
+ private:
+  virtual ~CountingModelWorker() {}
+
+  int work_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingModelWorker);
+};
 } // namespace
 
 // Test update application for a few bookmark items.
@@ -407,6 +434,44 @@ TEST_F(DirectoryUpdateHandlerApplyUpdateTest,
   }
 }
 
+// Test that updates applied one per transaction can still be delivered with
+// children before their parents, and that each transaction is a separate work
+// item for the model's thread.
+TEST_F(DirectoryUpdateHandlerApplyUpdateTest,
+       BookmarkChildrenBeforeParentInSlices) {
+  std::string root_server_id = syncable::GetNullId().GetServerId();
+  std::vector<int64> handles;
+  handles.push_back(entry_factory()->CreateUnappliedNewBookmarkItemWithParent(
+      "grandchild", DefaultBookmarkSpecifics(), "child"));
+  handles.push_back(entry_factory()->CreateUnappliedNewBookmarkItemWithParent(
+      "child", DefaultBookmarkSpecifics(), "parent"));
+  handles.push_back(entry_factory()->CreateUnappliedNewBookmarkItemWithParent(
+      "parent", DefaultBookmarkSpecifics(), root_server_id));
+
+  Cryptographer* cryptographer = NULL;
+  {
+    syncable::ReadTransaction trans(FROM_HERE, directory());
+    cryptographer = directory()->GetCryptographer(&trans);
+  }
+  scoped_refptr<CountingModelWorker> worker(new CountingModelWorker);
+  UpdateApplicator applicator(cryptographer);
+  EXPECT_EQ(SYNCER_OK, applicator.AttemptApplicationsInSlices(
+                           directory(), worker.get(), handles, 1));
+  EXPECT_EQ(3, applicator.updates_applied());
+  EXPECT_EQ(0, applicator.hierarchy_conflicts());
+
+  // Each pass applies one update: the parent, then the child, then the
+  // grandchild.
+  EXPECT_EQ(3 + 2 + 1, worker->work_count());
+
+  syncable::ReadTransaction trans(FROM_HERE, directory());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    syncable::Entry entry(&trans, syncable::GET_BY_HANDLE, handles[i]);
+    ASSERT_TRUE(entry.good());
+    EXPECT_FALSE(entry.GetIsUnappliedUpdate());
+  }
+}
+
 // Try to apply changes on an item that is both IS_UNSYNCED and
 // IS_UNAPPLIED_UPDATE.  Conflict resolution should be performed.
 TEST_F(DirectoryUpdateHandlerApplyUpdateTest, SimpleBookmarkConflict) {
@@ -41,6 +41,10 @@ static const bool kCreateMobileBookmarksFolder = true;
 static const bool kCreateMobileBookmarksFolder = false;
 #endif
 
+// A download which leaves more dirty entries than this is saved before the
+// next batch is requested, rather than in one snapshot at the end.
+static const size_t kMaxDirtyEntriesBetweenSaves = 2000;
+
 using sessions::StatusController;
 using sessions::SyncSession;
 using sessions::NudgeTracker;
@@ -156,6 +160,16 @@ bool Syncer::DownloadAndApplyUpdates(
                                                        &msg);
     session->mutable_status_controller()->set_last_download_updates_result(
         download_result);
+
+    // Each batch is stored along with its progress marker, so it is safe to
+    // save between batches.  This bounds how long each save holds the
+    // directory locks and how much it writes in one database transaction.
+    syncable::Directory* directory = session->context()->directory();
+    if (download_result == SERVER_MORE_TO_DOWNLOAD &&
+        directory->GetDirtyEntryCount() > kMaxDirtyEntriesBetweenSaves) {
+      TRACE_EVENT0("sync", "SaveChangesBetweenBatches");
+      directory->SaveChanges();
+    }
   } while (download_result == SERVER_MORE_TO_DOWNLOAD);
 
   // Exit without applying if we're shutting down or an error was detected.
@@ -4,10 +4,13 @@
 
 #include "sync/engine/update_applicator.h"
 
+#include <algorithm>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "sync/engine/syncer_util.h"
+#include "sync/syncable/directory.h"
 #include "sync/syncable/entry.h"
 #include "sync/syncable/mutable_entry.h"
 #include "sync/syncable/syncable_id.h"
@@ -51,34 +54,8 @@ void UpdateApplicator::AttemptApplications(
   DVLOG(1) << "UpdateApplicator running over " << to_apply.size() << " items.";
   while (!to_apply.empty()) {
     std::vector<int64> to_reapply;
-
-    for (std::vector<int64>::iterator i = to_apply.begin();
-         i != to_apply.end(); ++i) {
-      syncable::MutableEntry entry(trans, syncable::GET_BY_HANDLE, *i);
-      UpdateAttemptResponse result = AttemptToUpdateEntry(
-          trans, &entry, cryptographer_);
-
-      switch (result) {
-        case SUCCESS:
-          updates_applied_++;
-          break;
-        case CONFLICT_SIMPLE:
-          simple_conflict_ids_.insert(entry.GetId());
-          break;
-        case CONFLICT_ENCRYPTION:
-          encryption_conflicts_++;
-          break;
-        case CONFLICT_HIERARCHY:
-          // The decision to classify these as hierarchy conflcits is tentative.
-          // If we make any progress this round, we'll clear the hierarchy
-          // conflict count and attempt to reapply these updates.
-          to_reapply.push_back(*i);
-          break;
-        default:
-          NOTREACHED();
-          break;
-      }
-    }
+    AttemptApplicationPass(trans, to_apply.begin(), to_apply.end(),
+                           &to_reapply);
 
     if (to_reapply.size() == to_apply.size()) {
       // We made no progress.  Must be stubborn hierarchy conflicts.
@@ -90,7 +67,89 @@ void UpdateApplicator::AttemptApplications(
     // If everything went well, to_reapply will be empty and we'll break out on
     // the while condition.
     to_apply.swap(to_reapply);
-    to_reapply.clear();
+  }
+}
+
+SyncerError UpdateApplicator::AttemptApplicationsInSlices(
+    syncable::Directory* dir,
+    ModelSafeWorker* worker,
+    const std::vector<int64>& handles,
+    size_t max_updates_per_transaction) {
+  DCHECK_GT(max_updates_per_transaction, 0u);
+  std::vector<int64> to_apply = handles;
+
+  DVLOG(1) << "UpdateApplicator running over " << to_apply.size()
+           << " items in slices of " << max_updates_per_transaction << ".";
+  while (!to_apply.empty()) {
+    std::vector<int64> to_reapply;
+    for (size_t begin = 0; begin < to_apply.size();
+         begin += max_updates_per_transaction) {
+      size_t end =
+          std::min(begin + max_updates_per_transaction, to_apply.size());
+      // We wait until the callback is executed.  We can safely use
+      // Unretained.
+      WorkCallback slice = base::Bind(
+          &UpdateApplicator::AttemptApplicationSlice,
+          base::Unretained(this), dir, base::Unretained(&to_apply),
+          begin, end, base::Unretained(&to_reapply));
+      SyncerError result =
+          worker ? worker->DoWorkAndWaitUntilDone(slice) : slice.Run();
+      if (result != SYNCER_OK)
+        return result;
+    }
+
+    // See AttemptApplications().
+    if (to_reapply.size() == to_apply.size()) {
+      hierarchy_conflicts_ = to_apply.size();
+      break;
+    }
+    to_apply.swap(to_reapply);
+  }
+  return SYNCER_OK;
+}
+
+SyncerError UpdateApplicator::AttemptApplicationSlice(
+    syncable::Directory* dir,
+    const std::vector<int64>* to_apply,
+    size_t begin,
+    size_t end,
+    std::vector<int64>* to_reapply) {
+  syncable::WriteTransaction trans(FROM_HERE, syncable::SYNCER, dir);
+  AttemptApplicationPass(&trans, to_apply->begin() + begin,
+                         to_apply->begin() + end, to_reapply);
+  return SYNCER_OK;
+}
+
+void UpdateApplicator::AttemptApplicationPass(
+    syncable::WriteTransaction* trans,
+    std::vector<int64>::const_iterator begin,
+    std::vector<int64>::const_iterator end,
+    std::vector<int64>* to_reapply) {
+  for (std::vector<int64>::const_iterator i = begin; i != end; ++i) {
+    syncable::MutableEntry entry(trans, syncable::GET_BY_HANDLE, *i);
+    UpdateAttemptResponse result = AttemptToUpdateEntry(
+        trans, &entry, cryptographer_);
+
+    switch (result) {
+      case SUCCESS:
+        updates_applied_++;
+        break;
+      case CONFLICT_SIMPLE:
+        simple_conflict_ids_.insert(entry.GetId());
+        break;
+      case CONFLICT_ENCRYPTION:
+        encryption_conflicts_++;
+        break;
+      case CONFLICT_HIERARCHY:
+        // The decision to classify these as hierarchy conflcits is tentative.
+        // If we make any progress this round, we'll clear the hierarchy
+        // conflict count and attempt to reapply these updates.
+        to_reapply->push_back(*i);
+        break;
+      default:
+        NOTREACHED();
+        break;
+    }
   }
 }
 
@@ -26,6 +26,7 @@ class StatusController;
 }
 
 namespace syncable {
+class Directory;
 class WriteTransaction;
 class Entry;
 }
@@ -42,6 +43,20 @@ class UpdateApplicator {
   void AttemptApplications(syncable::WriteTransaction* trans,
                            const std::vector<int64>& handles);
 
+  // Like AttemptApplications(), but each pass over the updates is split into
+  // write transactions on |dir| of at most |max_updates_per_transaction|
+  // updates.  Each transaction leaves the directory consistent: an update
+  // whose parent has not been applied yet is retried by a later pass.
+  //
+  // Each transaction is posted to |worker| as a separate work item, so that
+  // the model's thread can run its own tasks in between, or is run directly
+  // if |worker| is NULL.  Stops and returns the error if |worker| could not
+  // run one.
+  SyncerError AttemptApplicationsInSlices(syncable::Directory* dir,
+                                          ModelSafeWorker* worker,
+                                          const std::vector<int64>& handles,
+                                          size_t max_updates_per_transaction);
+
   int updates_applied() {
     return updates_applied_;
   }
@@ -62,6 +77,20 @@ class UpdateApplicator {
   // If true, AttemptOneApplication will skip over |entry| and return true.
   bool SkipUpdate(const syncable::Entry& entry);
 
+  // Applies |to_apply|[|begin|, |end|) once in a write transaction on |dir|.
+  SyncerError AttemptApplicationSlice(syncable::Directory* dir,
+                                      const std::vector<int64>* to_apply,
+                                      size_t begin,
+                                      size_t end,
+                                      std::vector<int64>* to_reapply);
+
+  // Attempts to apply the updates in [|begin|, |end|) once, appending those
+  // which failed with a hierarchy conflict to |to_reapply|.
+  void AttemptApplicationPass(syncable::WriteTransaction* trans,
+                              std::vector<int64>::const_iterator begin,
+                              std::vector<int64>::const_iterator end,
+                              std::vector<int64>* to_reapply);
+
   // Used to decrypt sensitive sync nodes.
   Cryptographer* cryptographer_;
 
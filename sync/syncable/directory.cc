@@ -8,6 +8,7 @@
 
 #include "base/base64.h"
 #include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "sync/internal_api/public/base/unique_position.h"
@@ -501,8 +502,16 @@ bool Directory::SaveChanges() {
 
   // Snapshot and save.
   SaveChangesSnapshot snapshot;
+  base::TimeTicks start_time = base::TimeTicks::Now();
   TakeSnapshotForSaveChanges(&snapshot);
+  base::TimeTicks snapshot_time = base::TimeTicks::Now();
   success = store_->SaveChanges(snapshot);
+  UMA_HISTOGRAM_TIMES("Sync.DirectorySnapshotTime",
+                      snapshot_time - start_time);
+  UMA_HISTOGRAM_TIMES("Sync.DirectoryStoreSaveTime",
+                      base::TimeTicks::Now() - snapshot_time);
+  UMA_HISTOGRAM_COUNTS("Sync.DirectorySaveDirtyEntries",
+                       static_cast<int>(snapshot.dirty_metas.size()));
 
   // Handle success or failure.
   if (success)
@@ -774,6 +783,11 @@ size_t Directory::GetEntriesCount() const {
   return kernel_->metahandles_map.size();
 }
 
+size_t Directory::GetDirtyEntryCount() const {
+  ScopedKernelLock lock(this);
+  return kernel_->dirty_metahandles.size();
+}
+
 void Directory::SetDownloadProgress(
     ModelType model_type,
     const sync_pb::DataTypeProgressMarker& new_progress) {
@@ -297,6 +297,12 @@ class SYNC_EXPORT Directory {
   // WARNING: THIS METHOD PERFORMS SYNCHRONOUS I/O VIA SQLITE.
   bool SaveChanges();
 
+  // Returns the number of entries SaveChanges() would write, give or take a
+  // few false positives.  The snapshot holds the transaction and kernel locks
+  // for as long as it takes to copy these, so long running writers such as a
+  // large download use this to save between batches.
+  size_t GetDirtyEntryCount() const;
+
   // Returns the number of entities with the unsynced bit set.
   int64 unsynced_entity_count() const;
 
@@ -543,6 +543,21 @@ class SyncableDirectoryTest : public testing::Test {
   DirOpenResult ReloadDirImpl();
 };
 
+TEST_F(SyncableDirectoryTest, GetDirtyEntryCount) {
+  ASSERT_TRUE(dir_->SaveChanges());
+  EXPECT_EQ(0u, dir_->GetDirtyEntryCount());
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir_.get());
+    for (int i = 0; i < 10; i++) {
+      MutableEntry e(&trans, CREATE, BOOKMARKS, trans.root_id(), "foo");
+      e.PutIsUnsynced(true);
+    }
+  }
+  EXPECT_EQ(10u, dir_->GetDirtyEntryCount());
+  ASSERT_TRUE(dir_->SaveChanges());
+  EXPECT_EQ(0u, dir_->GetDirtyEntryCount());
+}
+
 TEST_F(SyncableDirectoryTest, TakeSnapshotGetsMetahandlesToPurge) {
   const int metas_to_create = 50;
   MetahandleSet expected_purges;
@@ -2,11 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
+
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
 #include "base/lazy_instance.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
 #include "env_chromium_stdio.h"
 #include "third_party/re2/re2/re2.h"
 
@@ -30,6 +33,16 @@ const base::FilePath::CharType table_extension[] = FILE_PATH_LITERAL(".ldb");
 static const base::FilePath::CharType kLevelDBTestDirectoryPrefix[]
     = FILE_PATH_LITERAL("leveldb-test-");
 
+// Upper bound on the number of background threads each env will start. Every
+// LevelDB database in the process shares the env, so this bounds the number of
+// compactions that can run at once.
+const int kMaxBackgroundThreads = 4;
+
+int GetMaxBackgroundThreads() {
+  return std::max(1, std::min(kMaxBackgroundThreads,
+                              base::SysInfo::NumberOfProcessors() / 2));
+}
+
 class ChromiumFileLock : public FileLock {
  public:
   ::base::File file_;
@@ -353,7 +366,9 @@ ChromiumEnv::ChromiumEnv()
     : name_("LevelDBEnv"),
       make_backup_(false),
       bgsignal_(&mu_),
-      started_bgthread_(false),
+      max_bgthreads_(GetMaxBackgroundThreads()),
+      num_bgthreads_(0),
+      idle_bgthreads_(0),
       kMaxRetryTimeMillis(1000) {
 }
 
@@ -731,6 +746,15 @@ base::HistogramBase* ChromiumEnv::GetLockFileAncestorHistogram() const {
       base::Histogram::kUmaTargetedHistogramFlag);
 }
 
+base::HistogramBase* ChromiumEnv::GetBGQueueTimeHistogram() const {
+  std::string uma_name(name_);
+  uma_name.append(".TimeInBackgroundQueue");
+  return base::Histogram::FactoryTimeGet(
+      uma_name, base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(30), 50,
+      base::Histogram::kUmaTargetedHistogramFlag);
+}
+
 base::HistogramBase* ChromiumEnv::GetRetryTimeHistogram(MethodID method) const {
   std::string uma_name(name_);
   // TODO(dgrogan): This is probably not the best way to concatenate strings.
@@ -777,23 +801,28 @@ class Thread : public ::base::PlatformThread::Delegate {
 void ChromiumEnv::Schedule(void (*function)(void*), void* arg) {
   mu_.Acquire();
 
-  // Start background thread if necessary
-  if (!started_bgthread_) {
-    started_bgthread_ = true;
-    StartThread(&ChromiumEnv::BGThreadWrapper, this);
-  }
-
-  // If the queue is currently empty, the background thread may currently be
-  // waiting.
-  if (queue_.empty()) {
-    bgsignal_.Signal();
+  BGQueue& queue = queues_[arg];
+  const bool was_empty = queue.empty();
+  queue.push_back(BGItem());
+  queue.back().function = function;
+  queue.back().arg = arg;
+  queue.back().schedule_time = ::base::TimeTicks::Now();
+
+  // If |arg| already had queued or running work, the thread that picks that
+  // up will also drain this item.
+  if (was_empty && running_.find(arg) == running_.end()) {
+    ready_.push_back(arg);
+    // Start another background thread if every existing one is busy,
+    // otherwise wake one of the waiting threads.
+    if (static_cast<int>(ready_.size()) > idle_bgthreads_ &&
+        num_bgthreads_ < max_bgthreads_) {
+      ++num_bgthreads_;
+      StartThread(&ChromiumEnv::BGThreadWrapper, this);
+    } else {
+      bgsignal_.Signal();
+    }
   }
 
-  // Add to priority queue
-  queue_.push_back(BGItem());
-  queue_.back().function = function;
-  queue_.back().arg = arg;
-
   mu_.Release();
 }
 
@@ -803,17 +832,38 @@ void ChromiumEnv::BGThread() {
   while (true) {
     // Wait until there is an item that is ready to run
     mu_.Acquire();
-    while (queue_.empty()) {
+    while (ready_.empty()) {
+      ++idle_bgthreads_;
       bgsignal_.Wait();
+      --idle_bgthreads_;
     }
 
-    void (*function)(void*) = queue_.front().function;
-    void* arg = queue_.front().arg;
-    queue_.pop_front();
+    void* db = ready_.front();
+    ready_.pop_front();
+    BGQueue& queue = queues_[db];
+    DCHECK(!queue.empty());
+    BGItem item = queue.front();
+    queue.pop_front();
+    running_.insert(db);
+
+    mu_.Release();
+    GetBGQueueTimeHistogram()->AddTime(::base::TimeTicks::Now() -
+                                       item.schedule_time);
+    {
+      TRACE_EVENT0("leveldb", "ChromiumEnv::BGThread-Task");
+      (*item.function)(item.arg);
+    }
+    mu_.Acquire();
+
+    // Go to the back of the line so that other databases get a turn before
+    // |db| runs again.
+    running_.erase(db);
+    if (queue.empty())
+      queues_.erase(db);
+    else
+      ready_.push_back(db);
 
     mu_.Release();
-    TRACE_EVENT0("leveldb", "ChromiumEnv::BGThread-Task");
-    (*function)(arg);
   }
 }
 
@@ -168,7 +168,7 @@ class ChromiumEnv : public leveldb::Env,
   base::Lock map_lock_;
 
   const int kMaxRetryTimeMillis;
-  // BGThread() is the body of the background thread
+  // BGThread() is the body of each thread in the background pool.
   void BGThread();
   static void BGThreadWrapper(void* arg) {
     reinterpret_cast<ChromiumEnv*>(arg)->BGThread();
@@ -181,6 +181,7 @@ class ChromiumEnv : public leveldb::Env,
   void RecordLockFileAncestors(int num_missing_ancestors) const;
   base::HistogramBase* GetMethodIOErrorHistogram() const;
   base::HistogramBase* GetLockFileAncestorHistogram() const;
+  base::HistogramBase* GetBGQueueTimeHistogram() const;
 
   // RetrierProvider implementation.
   virtual int MaxRetryTimeMillis() const { return kMaxRetryTimeMillis; }
@@ -192,15 +193,24 @@ class ChromiumEnv : public leveldb::Env,
 
   ::base::Lock mu_;
   ::base::ConditionVariable bgsignal_;
-  bool started_bgthread_;
+  const int max_bgthreads_;
+  int num_bgthreads_;
+  int idle_bgthreads_;
 
   // Entry per Schedule() call
   struct BGItem {
     void* arg;
     void (*function)(void*);
+    ::base::TimeTicks schedule_time;
   };
   typedef std::deque<BGItem> BGQueue;
-  BGQueue queue_;
+  // Work is queued per |arg|, which LevelDB sets to the DB that scheduled it,
+  // so that a long compaction in one database only ties up one thread of the
+  // pool. Items for the same arg run one at a time and in order.
+  std::map<void*, BGQueue> queues_;
+  // args that have queued work and nothing running, in round-robin order.
+  std::deque<void*> ready_;
+  std::set<void*> running_;
   LockTable locks_;
 };
 
@@ -7,6 +7,8 @@
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
 #include "base/test/test_suite.h"
 #include "env_chromium_stdio.h"
 #if defined(OS_WIN)
@@ -255,4 +257,43 @@ TEST(ChromiumEnv, GetChildrenPriorResults) {
   EXPECT_EQ(1, result.size());
 }
 
+namespace {
+
+struct BlockingTask {
+  BlockingTask() : started(false, false), release(false, false) {}
+  base::WaitableEvent started;
+  base::WaitableEvent release;
+};
+
+void RunBlockingTask(void* arg) {
+  BlockingTask* task = reinterpret_cast<BlockingTask*>(arg);
+  task->started.Signal();
+  task->release.Wait();
+}
+
+void SignalEvent(void* arg) {
+  reinterpret_cast<base::WaitableEvent*>(arg)->Signal();
+}
+
+}  // namespace
+
+TEST(ChromiumEnv, ScheduleNotBlockedByOtherDatabase) {
+  // The background pool only has more than one thread on multi-core machines.
+  if (base::SysInfo::NumberOfProcessors() < 4)
+    return;
+
+  // Work scheduled for one database (identified by its arg) should run while
+  // a long task for another database is still in progress.
+  Env* env = IDBEnv();
+  BlockingTask compaction;
+  env->Schedule(&RunBlockingTask, &compaction);
+  compaction.started.Wait();
+
+  base::WaitableEvent other_db_ran(false, false);
+  env->Schedule(&SignalEvent, &other_db_ran);
+  EXPECT_TRUE(other_db_ran.TimedWait(base::TimeDelta::FromSeconds(10)));
+
+  compaction.release.Signal();
+}
+
 int main(int argc, char** argv) { return base::TestSuite(argc, argv).Run(); }
@@ -27,7 +27,7 @@ namespace {
 const int kCurrentVersion = 6;
 const int kCompatibleVersion = 6;
 #else
-const int kCurrentVersion = 5;
+const int kCurrentVersion = 6;
 const int kCompatibleVersion = 5;
 #endif
 
@@ -151,6 +151,13 @@ const IndexInfo kIndexes[] = {
     kDeletableResponseIdsTable,
     "(response_id)",
     true },
+
+  // Main resource lookups search every cache for a URL, which the
+  // (cache_id, url) index can not serve.
+  { "EntriesUrlIndex",
+    kEntriesTable,
+    "(url)",
+    false },
 };
 
 const int kTableCount = ARRAYSIZE_UNSAFE(kTables);
@@ -1067,6 +1074,16 @@ bool AppCacheDatabase::EnsureDatabaseVersion() {
   if (meta_table_->GetVersionNumber() < kCurrentVersion)
     return UpgradeSchema();
 
+#if defined(APPCACHE_USE_SIMPLE_CACHE)
+  // Upgrading this schema deletes all stored caches, so EntriesUrlIndex is
+  // added in place instead of with a new version.
+  DCHECK_EQ(strcmp("EntriesUrlIndex", kIndexes[11].index_name), 0);
+  if (!db_->DoesIndexExist(kIndexes[11].index_name) &&
+      !CreateIndex(db_.get(), kIndexes[11])) {
+    return false;
+  }
+#endif
+
 #ifndef NDEBUG
   DCHECK(sql::MetaTable::DoesTableExist(db_.get()));
   for (int i = 0; i < kTableCount; ++i) {
@@ -1180,6 +1197,20 @@ bool AppCacheDatabase::UpgradeSchema() {
     }
     meta_table_->SetVersionNumber(5);
     meta_table_->SetCompatibleVersionNumber(5);
+    if (!transaction.Commit())
+      return false;
+  }
+
+  if (meta_table_->GetVersionNumber() == 5) {
+    // version 5 had no index on Entries.url. Version 5 code can still read the
+    // database, so the compatible version stays at 5.
+    DCHECK_EQ(strcmp(kEntriesTable, kIndexes[11].table_name), 0);
+    sql::Transaction transaction(db_.get());
+    if (!transaction.Begin() ||
+        !CreateIndex(db_.get(), kIndexes[11])) {
+      return false;
+    }
+    meta_table_->SetVersionNumber(6);
     return transaction.Commit();
   }
 
@@ -739,7 +739,7 @@ TEST(AppCacheDatabaseTest, OriginUsage) {
 #if defined(APPCACHE_USE_SIMPLE_CACHE)
 // There is no such upgrade path in this case.
 #else
-TEST(AppCacheDatabaseTest, UpgradeSchema3to5) {
+TEST(AppCacheDatabaseTest, UpgradeSchema3to6) {
   // Real file on disk for this test.
   base::ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
@@ -932,8 +932,9 @@ TEST(AppCacheDatabaseTest, UpgradeSchema3to5) {
   EXPECT_TRUE(db.db_->DoesIndexExist("NamespacesCacheAndUrlIndex"));
   EXPECT_TRUE(db.db_->DoesColumnExist("Namespaces", "is_pattern"));
   EXPECT_TRUE(db.db_->DoesColumnExist("OnlineWhiteLists", "is_pattern"));
+  EXPECT_TRUE(db.db_->DoesIndexExist("EntriesUrlIndex"));
 
-  EXPECT_EQ(5, db.meta_table_->GetVersionNumber());
+  EXPECT_EQ(6, db.meta_table_->GetVersionNumber());
   EXPECT_EQ(5, db.meta_table_->GetCompatibleVersionNumber());
 
   std::vector<AppCacheDatabase::NamespaceRecord> intercepts;
@@ -962,7 +963,7 @@ TEST(AppCacheDatabaseTest, UpgradeSchema3to5) {
 #if defined(APPCACHE_USE_SIMPLE_CACHE)
 // There is no such upgrade path in this case.
 #else
-TEST(AppCacheDatabaseTest, UpgradeSchema4to5) {
+TEST(AppCacheDatabaseTest, UpgradeSchema4to6) {
   // Real file on disk for this test.
   base::ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
@@ -1162,12 +1163,13 @@ TEST(AppCacheDatabaseTest, UpgradeSchema4to5) {
     EXPECT_TRUE(transaction.Commit());
   }
 
-  // Open that database and verify that it got upgraded to v5.
+  // Open that database and verify that it got upgraded to v6.
   AppCacheDatabase db(kDbFile);
   EXPECT_TRUE(db.LazyOpen(true));
   EXPECT_TRUE(db.db_->DoesColumnExist("Namespaces", "is_pattern"));
   EXPECT_TRUE(db.db_->DoesColumnExist("OnlineWhiteLists", "is_pattern"));
-  EXPECT_EQ(5, db.meta_table_->GetVersionNumber());
+  EXPECT_TRUE(db.db_->DoesIndexExist("EntriesUrlIndex"));
+  EXPECT_EQ(6, db.meta_table_->GetVersionNumber());
   EXPECT_EQ(5, db.meta_table_->GetCompatibleVersionNumber());
 
   std::vector<AppCacheDatabase::NamespaceRecord> intercepts;
@@ -1201,4 +1203,37 @@ TEST(AppCacheDatabaseTest, UpgradeSchema4to5) {
 }
 #endif  // !APPCACHE_USE_SIMPLE_CACHE
 
+#if defined(APPCACHE_USE_SIMPLE_CACHE)
+TEST(AppCacheDatabaseTest, EntriesUrlIndexAddedInPlace) {
+  // Real file on disk for this test.
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath kDbFile = temp_dir.path().AppendASCII("upgrade.db");
+  const GURL kUrl("http://blah/1");
+
+  // Create a database as it was before the index existed.
+  {
+    AppCacheDatabase db(kDbFile);
+    EXPECT_TRUE(db.LazyOpen(true));
+    AppCacheDatabase::EntryRecord entry;
+    entry.cache_id = 1;
+    entry.url = kUrl;
+    entry.flags = AppCacheEntry::MASTER;
+    entry.response_id = 1;
+    entry.response_size = 100;
+    EXPECT_TRUE(db.InsertEntry(&entry));
+    EXPECT_TRUE(db.db_->Execute("DROP INDEX EntriesUrlIndex"));
+  }
+
+  // Reopening it adds the index and keeps the stored entries.
+  AppCacheDatabase db(kDbFile);
+  EXPECT_TRUE(db.LazyOpen(true));
+  EXPECT_TRUE(db.db_->DoesIndexExist("EntriesUrlIndex"));
+  EXPECT_EQ(6, db.meta_table_->GetVersionNumber());
+  std::vector<AppCacheDatabase::EntryRecord> found;
+  EXPECT_TRUE(db.FindEntriesForUrl(kUrl, &found));
+  EXPECT_EQ(1U, found.size());
+}
+#endif  // APPCACHE_USE_SIMPLE_CACHE
+
 }  // namespace appcache
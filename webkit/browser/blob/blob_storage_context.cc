@@ -4,6 +4,8 @@
 
 #include "webkit/browser/blob/blob_storage_context.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -36,6 +38,11 @@ GURL ClearBlobUrlRef(const GURL& url) {
 // way to come up with a better limit.
 static const int64 kMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
 
+// A blob built from another blob shares the bytes items it covers at least
+// this fraction of, rather than copying them. Sharing a smaller slice would
+// keep the whole item alive for a few bytes.
+static const int kMinSharedFractionDenominator = 2;
+
 }  // namespace
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry()
@@ -65,7 +72,10 @@ scoped_ptr<BlobDataHandle> BlobStorageContext::GetBlobDataFromUUID(
     return result.Pass();
   if (found->second.flags & EXCEEDED_MEMORY)
     return result.Pass();
-  DCHECK(!(found->second.flags & BEING_BUILT));
+  // A blob still being built may change under blobs built from it, which
+  // share its bytes. The renderer can name any blob, so this is not a DCHECK.
+  if (found->second.flags & BEING_BUILT)
+    return result.Pass();
   result.reset(new BlobDataHandle(
       found->second.data.get(), this, base::MessageLoopProxy::current().get()));
   return result.Pass();
@@ -140,8 +150,8 @@ void BlobStorageContext::AppendBlobDataItem(
   //    modification time.
   // 3) The FileSystem File item is denoted by the FileSystem URL, the range
   //    and the expected modification time.
-  // 4) The Blob items are expanded.
-  // TODO(michaeln): Would be nice to avoid copying Data items when expanding.
+  // 4) The Blob items are expanded. Data items are shared with the source
+  //    blob rather than copied where that does not pin much more memory.
 
   DCHECK(item.length() > 0);
   switch (item.type()) {
@@ -167,7 +177,7 @@ void BlobStorageContext::AppendBlobDataItem(
       break;
     case BlobData::Item::TYPE_BLOB: {
       scoped_ptr<BlobDataHandle> src = GetBlobDataFromUUID(item.blob_uuid());
-      if (src)
+      if (src && src->data() != target_blob_data)
         exceeded_memory = !ExpandStorageItems(target_blob_data,
                                               src->data(),
                                               item.offset(),
@@ -183,7 +193,7 @@ void BlobStorageContext::AppendBlobDataItem(
   // TODO(michaeln): Blob memory storage does not yet spill over to disk,
   // as a stop gap, we'll prevent memory usage over a max amount.
   if (exceeded_memory) {
-    memory_usage_ -= target_blob_data->GetMemoryUsage();
+    ReleaseBlobData(target_blob_data);
     found->second.flags |= EXCEEDED_MEMORY;
     found->second.data = new BlobData(uuid);
     return;
@@ -220,8 +230,13 @@ void BlobStorageContext::DecrementBlobRefCount(const std::string& uuid) {
     return;
   DCHECK_EQ(found->second.data->uuid(), uuid);
   if (--(found->second.refcount) == 0) {
-    memory_usage_ -= found->second.data->GetMemoryUsage();
+    scoped_refptr<BlobData> blob_data = found->second.data;
     blob_map_.erase(found);
+    // Blobs built from this one may still be using its bytes.
+    if (sharer_counts_.find(blob_data.get()) != sharer_counts_.end())
+      released_blob_data_.push_back(blob_data);
+    else
+      ReleaseBlobData(blob_data.get());
   }
 }
 
@@ -231,6 +246,11 @@ bool BlobStorageContext::ExpandStorageItems(
   DCHECK(target_blob_data && src_blob_data &&
          length != static_cast<uint64>(-1));
 
+  // Only the bytes of a finished blob other than the target stay put.
+  bool can_share_bytes = target_blob_data != src_blob_data &&
+                         IsInUse(src_blob_data->uuid()) &&
+                         !IsBeingBuilt(src_blob_data->uuid());
+
   std::vector<BlobData::Item>::const_iterator iter =
       src_blob_data->items().begin();
   if (offset) {
@@ -246,10 +266,14 @@ bool BlobStorageContext::ExpandStorageItems(
     uint64 current_length = iter->length() - offset;
     uint64 new_length = current_length > length ? length : current_length;
     if (iter->type() == BlobData::Item::TYPE_BYTES) {
-      if (!AppendBytesItem(
-              target_blob_data,
-              iter->bytes() + static_cast<size_t>(iter->offset() + offset),
-              static_cast<int64>(new_length))) {
+      const char* bytes =
+          iter->bytes() + static_cast<size_t>(iter->offset() + offset);
+      if (can_share_bytes &&
+          new_length * kMinSharedFractionDenominator >= iter->length()) {
+        AppendSharedBytesItem(target_blob_data, src_blob_data, bytes,
+                              static_cast<int64>(new_length));
+      } else if (!AppendBytesItem(target_blob_data, bytes,
+                                  static_cast<int64>(new_length))) {
         return false;  // exceeded memory
       }
     } else if (iter->type() == BlobData::Item::TYPE_FILE) {
@@ -285,6 +309,19 @@ bool BlobStorageContext::AppendBytesItem(
   return true;
 }
 
+void BlobStorageContext::AppendSharedBytesItem(
+    BlobData* target_blob_data, BlobData* owner_blob_data,
+    const char* bytes, int64 length) {
+  DCHECK_GT(length, 0);
+  const std::vector<scoped_refptr<BlobData> >& owners =
+      target_blob_data->shared_data_owners();
+  if (std::find(owners.begin(), owners.end(), owner_blob_data) ==
+      owners.end())
+    ++sharer_counts_[owner_blob_data];
+  target_blob_data->AppendSharedData(bytes, static_cast<size_t>(length),
+                                     owner_blob_data);
+}
+
 void BlobStorageContext::AppendFileItem(
     BlobData* target_blob_data,
     const base::FilePath& file_path, uint64 offset, uint64 length,
@@ -307,6 +344,31 @@ void BlobStorageContext::AppendFileSystemFileItem(
                                          expected_modification_time);
 }
 
+void BlobStorageContext::ReleaseBlobData(BlobData* blob_data) {
+  memory_usage_ -= blob_data->GetMemoryUsage();
+  const std::vector<scoped_refptr<BlobData> >& owners =
+      blob_data->shared_data_owners();
+  for (std::vector<scoped_refptr<BlobData> >::const_iterator iter =
+           owners.begin();
+       iter != owners.end(); ++iter) {
+    SharerCountMap::iterator found = sharer_counts_.find(iter->get());
+    DCHECK(found != sharer_counts_.end());
+    if (found == sharer_counts_.end() || --(found->second) > 0)
+      continue;
+    sharer_counts_.erase(found);
+
+    // An owner still in |blob_map_| is released when its refcount drops.
+    std::vector<scoped_refptr<BlobData> >::iterator released =
+        std::find(released_blob_data_.begin(), released_blob_data_.end(),
+                  iter->get());
+    if (released == released_blob_data_.end())
+      continue;
+    scoped_refptr<BlobData> owner = *released;
+    released_blob_data_.erase(released);
+    ReleaseBlobData(owner.get());
+  }
+}
+
 bool BlobStorageContext::IsInUse(const std::string& uuid) {
   return blob_map_.find(uuid) != blob_map_.end();
 }
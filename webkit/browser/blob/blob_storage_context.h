@@ -7,7 +7,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -51,6 +53,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   friend class BlobDataHandle;
   friend class BlobStorageHost;
   friend class ViewBlobInternalsJob;
+  FRIEND_TEST_ALL_PREFIXES(BlobStorageContextTest, SharedBytes);
+  FRIEND_TEST_ALL_PREFIXES(BlobStorageContextTest, UnfinishedSourceBlob);
 
   enum EntryFlags {
     BEING_BUILT = 1 << 0,
@@ -70,6 +74,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   typedef std::map<std::string, BlobMapEntry>
       BlobMap;
   typedef std::map<GURL, std::string> BlobURLMap;
+  typedef std::map<const BlobData*, int> SharerCountMap;
 
   void StartBuildingBlob(const std::string& uuid);
   void AppendBlobDataItem(const std::string& uuid,
@@ -85,6 +90,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
                           uint64 length);
   bool AppendBytesItem(BlobData* target_blob_data,
                        const char* data, int64 length);
+  void AppendSharedBytesItem(BlobData* target_blob_data,
+                             BlobData* owner_blob_data,
+                             const char* data, int64 length);
   void AppendFileItem(BlobData* target_blob_data,
                       const base::FilePath& file_path,
                       uint64 offset, uint64 length,
@@ -94,6 +102,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
       const GURL& url, uint64 offset, uint64 length,
       const base::Time& expected_modification_time);
 
+  // Stops counting the memory of |blob_data|, which is no longer used, and
+  // drops its share of the bytes of the blobs it was built from. Released
+  // blobs left with no sharers are then released as well.
+  void ReleaseBlobData(BlobData* blob_data);
+
   bool IsInUse(const std::string& uuid);
   bool IsBeingBuilt(const std::string& uuid);
   bool IsUrlRegistered(const GURL& blob_url);
@@ -101,9 +114,16 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   BlobMap blob_map_;
   BlobURLMap public_blob_urls_;
 
+  // The number of blobs sharing the bytes of each blob that has sharers.
+  SharerCountMap sharer_counts_;
+
+  // Blobs which are no longer in |blob_map_|, but whose bytes are still
+  // shared by other blobs.
+  std::vector<scoped_refptr<BlobData> > released_blob_data_;
+
   // Used to keep track of how much memory is being utitlized for blob data,
   // we count only the items of TYPE_DATA which are held in memory and not
-  // items of TYPE_FILE.
+  // items of TYPE_FILE. Shared bytes are counted once, for their owner.
   int64 memory_usage_;
 
   DISALLOW_COPY_AND_ASSIGN(BlobStorageContext);
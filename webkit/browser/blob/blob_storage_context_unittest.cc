@@ -131,6 +131,88 @@ TEST(BlobStorageContextTest, CompoundBlobs) {
   EXPECT_TRUE(*(blob_data_handle->data()) == *canonicalized_blob_data2.get());
 }
 
+TEST(BlobStorageContextTest, SharedBytes) {
+  const std::string kId1("id1");
+  const std::string kId2("id2");
+
+  base::MessageLoop fake_io_message_loop;
+
+  scoped_refptr<BlobData> blob_data1(new BlobData(kId1));
+  blob_data1->AppendData("0123456789");
+  blob_data1->AppendData("abcdefghij");
+
+  // The first item is mostly covered and shared, the second is copied.
+  scoped_refptr<BlobData> blob_data2(new BlobData(kId2));
+  blob_data2->AppendBlob(kId1, 2, 10);
+
+  BlobStorageContext context;
+  scoped_ptr<BlobDataHandle> blob_data_handle1 =
+      context.AddFinishedBlob(blob_data1.get());
+  scoped_ptr<BlobDataHandle> blob_data_handle2 =
+      context.AddFinishedBlob(blob_data2.get());
+  ASSERT_TRUE(blob_data_handle2.get());
+  const std::vector<BlobData::Item>& items =
+      blob_data_handle2->data()->items();
+  ASSERT_EQ(2u, items.size());
+  EXPECT_EQ(blob_data_handle1->data()->items()[0].bytes() + 2,
+            items[0].bytes());
+  EXPECT_EQ(20, blob_data_handle1->data()->GetMemoryUsage());
+  EXPECT_EQ(2, blob_data_handle2->data()->GetMemoryUsage());
+  EXPECT_EQ(22, context.memory_usage_);
+
+  // The shared bytes outlive the blob they came from, and stay counted.
+  blob_data_handle1.reset();
+  fake_io_message_loop.RunUntilIdle();
+  EXPECT_FALSE(context.GetBlobDataFromUUID(kId1));
+  EXPECT_EQ("23456789", std::string(items[0].bytes(), items[0].length()));
+  EXPECT_EQ("ab", std::string(items[1].bytes(), items[1].length()));
+  EXPECT_EQ(22, context.memory_usage_);
+
+  // Releasing the last blob sharing them uncounts them.
+  blob_data_handle2.reset();
+  fake_io_message_loop.RunUntilIdle();
+  EXPECT_EQ(0, context.memory_usage_);
+}
+
+TEST(BlobStorageContextTest, UnfinishedSourceBlob) {
+  BlobStorageContext context;
+  BlobStorageHost host(&context);
+  base::MessageLoop fake_io_message_loop;
+
+  const std::string kSourceId("source");
+  const std::string kTargetId("target");
+  BlobData::Item bytes_item;
+  bytes_item.SetToBytes("0123456789", 10);
+  EXPECT_TRUE(host.StartBuildingBlob(kSourceId));
+  EXPECT_TRUE(host.AppendBlobDataItem(kSourceId, bytes_item));
+  EXPECT_FALSE(context.GetBlobDataFromUUID(kSourceId));
+
+  // Neither an unfinished blob nor the target itself can be expanded.
+  EXPECT_TRUE(host.StartBuildingBlob(kTargetId));
+  BlobData::Item blob_item;
+  blob_item.SetToBlobRange(kSourceId, 0, 10);
+  EXPECT_TRUE(host.AppendBlobDataItem(kTargetId, blob_item));
+  blob_item.SetToBlobRange(kTargetId, 0, 10);
+  EXPECT_TRUE(host.AppendBlobDataItem(kTargetId, blob_item));
+  EXPECT_TRUE(host.AppendBlobDataItem(kTargetId, bytes_item));
+
+  // Growing the source must not affect the target.
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(host.AppendBlobDataItem(kSourceId, bytes_item));
+  EXPECT_TRUE(host.FinishBuildingBlob(kSourceId, "text/plain"));
+  EXPECT_TRUE(host.FinishBuildingBlob(kTargetId, "text/plain"));
+
+  scoped_ptr<BlobDataHandle> blob_data_handle =
+      context.GetBlobDataFromUUID(kTargetId);
+  ASSERT_TRUE(blob_data_handle);
+  const std::vector<BlobData::Item>& items =
+      blob_data_handle->data()->items();
+  ASSERT_EQ(1u, items.size());
+  EXPECT_EQ("0123456789", std::string(items[0].bytes(), items[0].length()));
+  EXPECT_TRUE(blob_data_handle->data()->shared_data_owners().empty());
+  EXPECT_TRUE(context.sharer_counts_.empty());
+}
+
 TEST(BlobStorageContextTest, PublicBlobUrls) {
   BlobStorageContext context;
   BlobStorageHost host(&context);
@@ -836,11 +836,7 @@ bool ObfuscatedFileUtil::IsDirectoryEmpty(
   }
   if (!file_info.is_directory())
     return true;
-  std::vector<FileId> children;
-  // TODO(ericu): This could easily be made faster with help from the database.
-  if (!db->ListChildren(file_id, &children))
-    return true;
-  return children.empty();
+  return db->IsDirectoryEmpty(file_id);
 }
 
 base::FilePath ObfuscatedFileUtil::GetDirectoryForOriginAndType(
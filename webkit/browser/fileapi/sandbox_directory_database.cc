@@ -74,6 +74,7 @@ const char kChildLookupSeparator[] = ":";
 const char kLastFileIdKey[] = "LAST_FILE_ID";
 const char kLastIntegerKey[] = "LAST_INTEGER";
 const int64 kMinimumReportIntervalHours = 1;
+const size_t kMaxCachedDirectoryIds = 1000;
 const char kInitStatusHistogramLabel[] = "FileSystem.DirectoryDatabaseInit";
 const char kDatabaseRepairHistogramLabel[] =
     "FileSystem.DirectoryDatabaseRepair";
@@ -447,15 +448,44 @@ bool SandboxDirectoryDatabase::GetFileWithPath(
     const base::FilePath& path, FileId* file_id) {
   std::vector<base::FilePath::StringType> components;
   VirtualPath::GetComponents(path, &components);
-  FileId local_id = 0;
+  std::vector<base::FilePath::StringType> names;
+  std::vector<base::FilePath> prefixes;
+  base::FilePath prefix;
   std::vector<base::FilePath::StringType>::iterator iter;
   for (iter = components.begin(); iter != components.end(); ++iter) {
-    base::FilePath::StringType name;
-    name = *iter;
-    if (name == FILE_PATH_LITERAL("/"))
+    if (*iter == FILE_PATH_LITERAL("/"))
       continue;
-    if (!GetChildWithName(local_id, name, &local_id))
+    prefix = prefix.Append(*iter);
+    names.push_back(*iter);
+    prefixes.push_back(prefix);
+  }
+
+  // Start below the deepest ancestor whose ID is cached.
+  FileId local_id = 0;
+  size_t first = prefixes.size();
+  while (first > 0) {
+    std::map<base::FilePath, FileId>::const_iterator found =
+        directory_id_cache_.find(prefixes[first - 1]);
+    if (found != directory_id_cache_.end()) {
+      local_id = found->second;
+      break;
+    }
+    --first;
+  }
+
+  std::vector<FileId> ids;
+  for (size_t i = first; i < prefixes.size(); ++i) {
+    if (!GetChildWithName(local_id, names[i], &local_id))
       return false;
+    ids.push_back(local_id);
+  }
+
+  // Now that the whole path resolved, its ancestors are known to be
+  // directories.
+  for (size_t i = first; i + 1 < prefixes.size(); ++i) {
+    if (directory_id_cache_.size() >= kMaxCachedDirectoryIds)
+      directory_id_cache_.clear();
+    directory_id_cache_[prefixes[i]] = ids[i - first];
   }
   *file_id = local_id;
   return true;
@@ -486,6 +516,16 @@ bool SandboxDirectoryDatabase::ListChildren(
   return true;
 }
 
+bool SandboxDirectoryDatabase::IsDirectoryEmpty(FileId parent_id) {
+  if (!Init(REPAIR_ON_CORRUPTION))
+    return true;
+  std::string child_key_prefix = GetChildListingKeyPrefix(parent_id);
+  scoped_ptr<leveldb::Iterator> iter(db_->NewIterator(leveldb::ReadOptions()));
+  iter->Seek(child_key_prefix);
+  return !iter->Valid() ||
+      !StartsWithASCII(iter->key().ToString(), child_key_prefix, true);
+}
+
 bool SandboxDirectoryDatabase::GetFileInfo(FileId file_id, FileInfo* info) {
   if (!Init(REPAIR_ON_CORRUPTION))
     return false;
@@ -605,6 +645,9 @@ bool SandboxDirectoryDatabase::UpdateFileInfo(
   if (!RemoveFileInfoHelper(file_id, &batch) ||
       !AddFileInfoHelper(new_info, file_id, &batch))
     return false;
+  // Moving a directory moves everything under it, and a file moved away
+  // frees its name for a directory.
+  directory_id_cache_.clear();
   leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
   if (!status.ok()) {
     HandleError(FROM_HERE, status);
@@ -913,15 +956,12 @@ bool SandboxDirectoryDatabase::RemoveFileInfoHelper(
   if (!GetFileInfo(file_id, &info))
     return false;
   if (info.data_path.empty()) {  // It's a directory
-    std::vector<FileId> children;
-    // TODO(ericu): Make a faster is-the-directory-empty check.
-    if (!ListChildren(file_id, &children))
-      return false;
-    if (children.size()) {
+    if (!IsDirectoryEmpty(file_id)) {
       LOG(ERROR) << "Can't remove a directory with children.";
       return false;
     }
   }
+  directory_id_cache_.clear();
   batch->Delete(GetChildLookupKey(info.parent_id, info.name));
   batch->Delete(GetFileLookupKey(file_id));
   return true;
@@ -933,6 +973,7 @@ void SandboxDirectoryDatabase::HandleError(
   LOG(ERROR) << "SandboxDirectoryDatabase failed at: "
              << from_here.ToString() << " with error: " << status.ToString();
   db_.reset();
+  directory_id_cache_.clear();
 }
 
 }  // namespace fileapi
@@ -5,6 +5,7 @@
 #ifndef WEBKIT_BROWSER_FILEAPI_SANDBOX_DIRECTORY_DATABASE_H_
 #define WEBKIT_BROWSER_FILEAPI_SANDBOX_DIRECTORY_DATABASE_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -70,6 +71,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE SandboxDirectoryDatabase {
   // ListChildren will succeed, returning 0 children, if parent_id doesn't
   // exist.
   bool ListChildren(FileId parent_id, std::vector<FileId>* children);
+  // Returns true if |parent_id| has no children, or doesn't exist. This only
+  // looks at the first child.
+  bool IsDirectoryEmpty(FileId parent_id);
   bool GetFileInfo(FileId file_id, FileInfo* info);
   base::File::Error AddFileInfo(const FileInfo& info, FileId* file_id);
   bool RemoveFileInfo(FileId file_id);
@@ -123,6 +127,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE SandboxDirectoryDatabase {
   leveldb::Env* env_override_;
   scoped_ptr<leveldb::DB> db_;
   base::Time last_reported_time_;
+
+  // IDs of directories resolved by GetFileWithPath(), keyed by virtual path,
+  // so that resolving a path only looks up the components below its deepest
+  // cached ancestor.  Walking a tree otherwise looks up every component of
+  // every entry.  Cleared whenever an entry is moved or removed.
+  std::map<base::FilePath, FileId> directory_id_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(SandboxDirectoryDatabase);
 };
 
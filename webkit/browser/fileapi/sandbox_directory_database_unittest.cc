@@ -313,6 +313,68 @@ TEST_F(SandboxDirectoryDatabaseTest, TestGetFileWithPath) {
   EXPECT_EQ(file_id2, check_file_id);
 }
 
+TEST_F(SandboxDirectoryDatabaseTest, TestGetFileWithPathAfterMove) {
+  FileId dir_id0;
+  FileId dir_id1;
+  FileId file_id;
+  CreateDirectory(0, FPL("foo"), &dir_id0);
+  CreateDirectory(dir_id0, FPL("bar"), &dir_id1);
+  CreateFile(dir_id1, FPL("dog"), FPL("data"), &file_id);
+
+  base::FilePath path = base::FilePath(FPL("foo")).Append(FPL("bar"));
+  FileId check_file_id;
+  EXPECT_TRUE(db()->GetFileWithPath(path.Append(FPL("dog")), &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // Renaming an ancestor must not leave its old path resolvable.
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(dir_id0, &info));
+  info.name = FPL("baz");
+  ASSERT_TRUE(db()->UpdateFileInfo(dir_id0, info));
+  EXPECT_FALSE(db()->GetFileWithPath(path.Append(FPL("dog")), &check_file_id));
+  path = base::FilePath(FPL("baz")).Append(FPL("bar"));
+  EXPECT_TRUE(db()->GetFileWithPath(path.Append(FPL("dog")), &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  EXPECT_FALSE(db()->IsDirectoryEmpty(dir_id1));
+  EXPECT_TRUE(db()->RemoveFileInfo(file_id));
+  EXPECT_TRUE(db()->IsDirectoryEmpty(dir_id1));
+}
+
+TEST_F(SandboxDirectoryDatabaseTest, TestGetFileWithPathThroughFile) {
+  FileId file_id;
+  CreateFile(0, FPL("a.txt"), FPL("data"), &file_id);
+
+  // A file is not a directory, even if a longer path was looked up through
+  // it.
+  base::FilePath path(FPL("a.txt"));
+  FileId check_file_id;
+  EXPECT_FALSE(db()->GetFileWithPath(path.Append(FPL("x")), &check_file_id));
+  EXPECT_TRUE(db()->GetFileWithPath(path, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // Renaming the file frees its name.
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(file_id, &info));
+  info.name = FPL("b.txt");
+  ASSERT_TRUE(db()->UpdateFileInfo(file_id, info));
+  EXPECT_FALSE(db()->GetFileWithPath(path, &check_file_id));
+  EXPECT_TRUE(db()->GetFileWithPath(base::FilePath(FPL("b.txt")),
+                                    &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // A directory created at the name of a removed file is usable.
+  ASSERT_TRUE(db()->RemoveFileInfo(file_id));
+  FileId dir_id;
+  FileId child_id;
+  CreateDirectory(0, FPL("a.txt"), &dir_id);
+  CreateFile(dir_id, FPL("x"), FPL("data"), &child_id);
+  EXPECT_TRUE(db()->GetFileWithPath(path, &check_file_id));
+  EXPECT_EQ(dir_id, check_file_id);
+  EXPECT_TRUE(db()->GetFileWithPath(path.Append(FPL("x")), &check_file_id));
+  EXPECT_EQ(child_id, check_file_id);
+}
+
 TEST_F(SandboxDirectoryDatabaseTest, TestListChildren) {
   // No children in the root.
   std::vector<FileId> children;
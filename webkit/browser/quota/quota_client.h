@@ -6,6 +6,7 @@
 #define WEBKIT_BROWSER_QUOTA_QUOTA_CLIENT_H_
 
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 
@@ -76,6 +77,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaClient {
 // TODO(dmikurube): Replace it to std::vector for efficiency.
 typedef std::list<QuotaClient*> QuotaClientList;
 
+// Cached per-origin usage of one storage type, keyed by the reporting client.
+typedef std::map<QuotaClient::ID, std::map<GURL, int64> > OriginUsageByClient;
+
 }  // namespace quota
 
 #endif  // WEBKIT_BROWSER_QUOTA_QUOTA_CLIENT_H_
@@ -10,6 +10,7 @@
 #include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/file_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "sql/connection.h"
 #include "sql/meta_table.h"
@@ -23,12 +24,23 @@ namespace {
 
 // Definitions for database schema.
 
-const int kCurrentVersion = 4;
+const int kCurrentVersion = 5;
 const int kCompatibleVersion = 2;
 
 const char kHostQuotaTable[] = "HostQuotaTable";
 const char kOriginInfoTable[] = "OriginInfoTable";
+const char kOriginUsageTable[] = "OriginUsageTable";
 const char kIsOriginTableBootstrapped[] = "IsOriginTableBootstrapped";
+const char kIsUsageLedgerValidPrefix[] = "IsUsageLedgerValid";
+
+// Shared with the version 4 to 5 upgrade, which only adds this table.
+const char kOriginUsageTableColumns[] =
+    "(origin TEXT NOT NULL,"
+    " type INTEGER NOT NULL,"
+    " client_id INTEGER NOT NULL,"
+    " usage INTEGER DEFAULT 0,"
+    " UNIQUE(origin, type, client_id))";
+const char kOriginUsageTypeIndexColumns[] = "(type)";
 
 bool VerifyValidQuotaConfig(const char* key) {
   return (key != NULL &&
@@ -58,6 +70,8 @@ const QuotaDatabase::TableSchema QuotaDatabase::kTables[] = {
     " last_access_time INTEGER DEFAULT 0,"
     " last_modified_time INTEGER DEFAULT 0,"
     " UNIQUE(origin, type))" },
+  { kOriginUsageTable,
+    kOriginUsageTableColumns },
 };
 
 // static
@@ -78,6 +92,10 @@ const QuotaDatabase::IndexSchema QuotaDatabase::kIndexes[] = {
     kOriginInfoTable,
     "(last_modified_time)",
     false },
+  { "OriginUsageTypeIndex",
+    kOriginUsageTable,
+    kOriginUsageTypeIndexColumns,
+    false },
 };
 
 struct QuotaDatabase::QuotaTableImporter {
@@ -391,6 +409,88 @@ bool QuotaDatabase::SetOriginDatabaseBootstrapped(bool bootstrap_flag) {
   return meta_table_->SetValue(kIsOriginTableBootstrapped, bootstrap_flag);
 }
 
+bool QuotaDatabase::GetUsageLedger(StorageType type,
+                                   OriginUsageByClient* usage) {
+  DCHECK(usage);
+  if (!LazyOpen(false) || !IsUsageLedgerValid(type))
+    return false;
+
+  // The caller's cache starts diverging from the ledger right away, so it
+  // must not be trusted again if we crash before the next SetUsageLedger().
+  if (!SetUsageLedgerValid(type, false))
+    return false;
+  Commit();
+
+  const char* kSql = "SELECT origin, client_id, usage FROM OriginUsageTable"
+                     " WHERE type = ?";
+
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+  statement.BindInt(0, static_cast<int>(type));
+
+  usage->clear();
+  while (statement.Step()) {
+    QuotaClient::ID client_id =
+        static_cast<QuotaClient::ID>(statement.ColumnInt(1));
+    (*usage)[client_id][GURL(statement.ColumnString(0))] =
+        statement.ColumnInt64(2);
+  }
+
+  return statement.Succeeded();
+}
+
+bool QuotaDatabase::SetUsageLedger(StorageType type,
+                                   const OriginUsageByClient& usage) {
+  if (!LazyOpen(true))
+    return false;
+
+  const char* kDeleteSql = "DELETE FROM OriginUsageTable WHERE type = ?";
+  sql::Statement delete_statement(
+      db_->GetCachedStatement(SQL_FROM_HERE, kDeleteSql));
+  delete_statement.BindInt(0, static_cast<int>(type));
+  if (!delete_statement.Run())
+    return false;
+
+  const char* kInsertSql =
+      "INSERT INTO OriginUsageTable"
+      " (origin, type, client_id, usage)"
+      " VALUES (?, ?, ?, ?)";
+  for (OriginUsageByClient::const_iterator client_itr = usage.begin();
+       client_itr != usage.end(); ++client_itr) {
+    for (std::map<GURL, int64>::const_iterator origin_itr =
+             client_itr->second.begin();
+         origin_itr != client_itr->second.end(); ++origin_itr) {
+      sql::Statement statement(
+          db_->GetCachedStatement(SQL_FROM_HERE, kInsertSql));
+      statement.BindString(0, origin_itr->first.spec());
+      statement.BindInt(1, static_cast<int>(type));
+      statement.BindInt(2, static_cast<int>(client_itr->first));
+      statement.BindInt64(3, origin_itr->second);
+
+      if (!statement.Run())
+        return false;
+    }
+  }
+
+  if (!SetUsageLedgerValid(type, true))
+    return false;
+
+  ScheduleCommit();
+  return true;
+}
+
+bool QuotaDatabase::IsUsageLedgerValid(StorageType type) {
+  std::string key =
+      kIsUsageLedgerValidPrefix + base::IntToString(static_cast<int>(type));
+  int flag = 0;
+  return meta_table_->GetValue(key.c_str(), &flag) && flag;
+}
+
+bool QuotaDatabase::SetUsageLedgerValid(StorageType type, bool valid) {
+  std::string key =
+      kIsUsageLedgerValidPrefix + base::IntToString(static_cast<int>(type));
+  return meta_table_->SetValue(key.c_str(), valid);
+}
+
 void QuotaDatabase::Commit() {
   if (!db_)
     return;
@@ -587,6 +687,23 @@ bool QuotaDatabase::UpgradeSchema(int current_version) {
     Commit();
     return true;
   }
+  if (current_version == 4) {
+    sql::Transaction transaction(db_.get());
+    if (!transaction.Begin())
+      return false;
+    std::string create_table("CREATE TABLE ");
+    create_table += kOriginUsageTable;
+    create_table += kOriginUsageTableColumns;
+    std::string create_index("CREATE INDEX OriginUsageTypeIndex ON ");
+    create_index += kOriginUsageTable;
+    create_index += kOriginUsageTypeIndexColumns;
+    if (!db_->Execute(create_table.c_str()) ||
+        !db_->Execute(create_index.c_str())) {
+      return false;
+    }
+    meta_table_->SetVersionNumber(kCurrentVersion);
+    return transaction.Commit();
+  }
   return false;
 }
 
@@ -16,6 +16,7 @@
 #include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "url/gurl.h"
+#include "webkit/browser/quota/quota_client.h"
 #include "webkit/browser/webkit_storage_browser_export.h"
 #include "webkit/common/quota/quota_types.h"
 
@@ -87,6 +88,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
   bool IsOriginDatabaseBootstrapped();
   bool SetOriginDatabaseBootstrapped(bool bootstrap_flag);
 
+  // The usage ledger holds the usage trackers' per-origin caches of |type|
+  // as of the end of the last session. GetUsageLedger() returns false unless
+  // it was written by SetUsageLedger() since it was last read, as the
+  // caller's cache diverges from it from then on.
+  bool GetUsageLedger(StorageType type, OriginUsageByClient* usage);
+  bool SetUsageLedger(StorageType type, const OriginUsageByClient& usage);
+
  private:
   struct WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaTableEntry {
     QuotaTableEntry();
@@ -143,6 +151,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
   void Commit();
   void ScheduleCommit();
 
+  bool IsUsageLedgerValid(StorageType type);
+  bool SetUsageLedgerValid(StorageType type, bool valid);
+
   bool FindOriginUsedCount(const GURL& origin,
                            StorageType type,
                            int* used_count);
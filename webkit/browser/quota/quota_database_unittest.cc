@@ -537,6 +537,47 @@ TEST_F(QuotaDatabaseTest, BootstrapFlag) {
   EXPECT_FALSE(db.IsOriginDatabaseBootstrapped());
 }
 
+TEST_F(QuotaDatabaseTest, UsageLedger) {
+  base::ScopedTempDir data_dir;
+  ASSERT_TRUE(data_dir.CreateUniqueTempDir());
+  const base::FilePath kDbFile = data_dir.path().AppendASCII(kDBFileName);
+
+  const GURL kOrigin1("http://a/");
+  const GURL kOrigin2("http://b/");
+  OriginUsageByClient usage;
+  usage[QuotaClient::kFileSystem][kOrigin1] = 10;
+  usage[QuotaClient::kFileSystem][kOrigin2] = 20;
+  usage[QuotaClient::kDatabase][kOrigin1] = 30;
+
+  {
+    QuotaDatabase db(kDbFile);
+    OriginUsageByClient loaded;
+    EXPECT_FALSE(db.GetUsageLedger(kStorageTypeTemporary, &loaded));
+    EXPECT_TRUE(db.SetUsageLedger(kStorageTypeTemporary, usage));
+  }
+
+  {
+    QuotaDatabase db(kDbFile);
+    OriginUsageByClient loaded;
+    EXPECT_FALSE(db.GetUsageLedger(kStorageTypePersistent, &loaded));
+    EXPECT_TRUE(db.GetUsageLedger(kStorageTypeTemporary, &loaded));
+    EXPECT_EQ(usage, loaded);
+  }
+
+  // Reading the ledger invalidated it.
+  {
+    QuotaDatabase db(kDbFile);
+    OriginUsageByClient loaded;
+    EXPECT_FALSE(db.GetUsageLedger(kStorageTypeTemporary, &loaded));
+
+    // Writing it again replaces the old entries.
+    usage.erase(QuotaClient::kDatabase);
+    EXPECT_TRUE(db.SetUsageLedger(kStorageTypeTemporary, usage));
+    EXPECT_TRUE(db.GetUsageLedger(kStorageTypeTemporary, &loaded));
+    EXPECT_EQ(usage, loaded);
+  }
+}
+
 TEST_F(QuotaDatabaseTest, RegisterInitialOriginInfo) {
   base::ScopedTempDir data_dir;
   ASSERT_TRUE(data_dir.CreateUniqueTempDir());
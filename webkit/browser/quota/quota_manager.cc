@@ -18,6 +18,7 @@
 #include "base/metrics/histogram.h"
 #include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/sys_info.h"
 #include "base/task_runner_util.h"
@@ -42,6 +43,7 @@ const int64 kMBytes = 1024 * 1024;
 const int kMinutesInMilliSeconds = 60 * 1000;
 
 const int64 kReportHistogramInterval = 60 * 60 * 1000;  // 1 hour
+const int64 kReconcileUsageDelay = 10 * kMinutesInMilliSeconds;
 const double kTemporaryQuotaRatioToAvail = 1.0 / 3.0;  // 33%
 
 }  // namespace
@@ -131,17 +133,40 @@ bool SetPersistentHostQuotaOnDBThread(const std::string& host,
   return false;
 }
 
-bool InitializeOnDBThread(int64* temporary_quota_override,
-                          int64* desired_available_space,
-                          QuotaDatabase* database) {
+const StorageType kUsageLedgerTypes[] = {
+  kStorageTypeTemporary,
+  kStorageTypePersistent,
+  kStorageTypeSyncable,
+};
+
+bool InitializeOnDBThread(
+    int64* temporary_quota_override,
+    int64* desired_available_space,
+    std::map<StorageType, OriginUsageByClient>* usage_ledgers,
+    QuotaDatabase* database) {
   DCHECK(database);
   database->GetQuotaConfigValue(QuotaDatabase::kTemporaryQuotaOverrideKey,
                                 temporary_quota_override);
   database->GetQuotaConfigValue(QuotaDatabase::kDesiredAvailableSpaceKey,
                                 desired_available_space);
+  for (size_t i = 0; i < arraysize(kUsageLedgerTypes); ++i) {
+    OriginUsageByClient usage;
+    if (database->GetUsageLedger(kUsageLedgerTypes[i], &usage))
+      (*usage_ledgers)[kUsageLedgerTypes[i]].swap(usage);
+  }
   return true;
 }
 
+void SetUsageLedgerOnDBThread(StorageType type,
+                              const OriginUsageByClient* usage,
+                              QuotaDatabase* database) {
+  DCHECK(database);
+  database->SetUsageLedger(type, *usage);
+}
+
+void NoopGlobalUsageCallback(int64 usage, int64 unlimited_usage) {
+}
+
 bool GetLRUOriginOnDBThread(StorageType type,
                             std::set<GURL>* exceptions,
                             SpecialStoragePolicy* policy,
@@ -1179,8 +1204,10 @@ QuotaManager::~QuotaManager() {
   proxy_->manager_ = NULL;
   std::for_each(clients_.begin(), clients_.end(),
                 std::mem_fun(&QuotaClient::OnQuotaManagerDestroyed));
-  if (database_)
+  if (database_) {
+    SaveUsageLedgers();
     db_thread_->DeleteSoon(FROM_HERE, database_.release());
+  }
 }
 
 QuotaManager::EvictionContext::EvictionContext()
@@ -1210,15 +1237,18 @@ void QuotaManager::LazyInitialize() {
 
   int64* temporary_quota_override = new int64(-1);
   int64* desired_available_space = new int64(-1);
+  UsageLedgers* usage_ledgers = new UsageLedgers;
   PostTaskAndReplyWithResultForDBThread(
       FROM_HERE,
       base::Bind(&InitializeOnDBThread,
                  base::Unretained(temporary_quota_override),
-                 base::Unretained(desired_available_space)),
+                 base::Unretained(desired_available_space),
+                 base::Unretained(usage_ledgers)),
       base::Bind(&QuotaManager::DidInitialize,
                  weak_factory_.GetWeakPtr(),
                  base::Owned(temporary_quota_override),
-                 base::Owned(desired_available_space)));
+                 base::Owned(desired_available_space),
+                 base::Owned(usage_ledgers)));
 }
 
 void QuotaManager::RegisterClient(QuotaClient* client) {
@@ -1408,6 +1438,49 @@ void QuotaManager::DidGetPersistentGlobalUsageForHistogram(
                        unlimited_origins);
 }
 
+void QuotaManager::SaveUsageLedgers() {
+  if (db_disabled_)
+    return;
+
+  for (size_t i = 0; i < arraysize(kUsageLedgerTypes); ++i) {
+    scoped_ptr<OriginUsageByClient> usage(new OriginUsageByClient);
+    if (!GetUsageTracker(kUsageLedgerTypes[i])->GetCachedUsageByClient(
+            usage.get()))
+      continue;
+    db_thread_->PostTask(
+        FROM_HERE,
+        base::Bind(&SetUsageLedgerOnDBThread,
+                   kUsageLedgerTypes[i],
+                   base::Owned(usage.release()),
+                   base::Unretained(database_.get())));
+  }
+}
+
+void QuotaManager::ReconcileUsage() {
+  // Usage seeded from the ledger does not know about data the clients
+  // added or removed while we were not running, so gather it once more in
+  // the background now that startup is over.
+  std::set<StorageType> busy_types;
+  for (std::set<StorageType>::const_iterator iter =
+           usage_types_to_reconcile_.begin();
+       iter != usage_types_to_reconcile_.end(); ++iter) {
+    UsageTracker* tracker = GetUsageTracker(*iter);
+    if (tracker->IsWorking()) {
+      busy_types.insert(*iter);
+      continue;
+    }
+    tracker->ResetUsageCache();
+    tracker->GetGlobalUsage(base::Bind(&NoopGlobalUsageCallback));
+  }
+
+  usage_types_to_reconcile_.swap(busy_types);
+  if (!usage_types_to_reconcile_.empty()) {
+    usage_reconciliation_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromMilliseconds(kReconcileUsageDelay),
+        this, &QuotaManager::ReconcileUsage);
+  }
+}
+
 void QuotaManager::GetLRUOrigin(
     StorageType type,
     const GetLRUOriginCallback& callback) {
@@ -1513,12 +1586,29 @@ void QuotaManager::DidSetPersistentHostQuota(const std::string& host,
 
 void QuotaManager::DidInitialize(int64* temporary_quota_override,
                                  int64* desired_available_space,
+                                 const UsageLedgers* usage_ledgers,
                                  bool success) {
   temporary_quota_override_ = *temporary_quota_override;
   desired_available_space_ = *desired_available_space;
   temporary_quota_initialized_ = true;
   DidDatabaseWork(success);
 
+  // Seed the usage caches before anything asks for usage, so that the
+  // first eviction round does not have to scan every origin.
+  for (UsageLedgers::const_iterator iter = usage_ledgers->begin();
+       iter != usage_ledgers->end(); ++iter) {
+    GetUsageTracker(iter->first)->SeedUsageCache(iter->second);
+    usage_types_to_reconcile_.insert(iter->first);
+  }
+  UMA_HISTOGRAM_BOOLEAN(
+      "Quota.TemporaryUsageSeededFromLedger",
+      ContainsKey(*usage_ledgers, kStorageTypeTemporary));
+  if (!usage_types_to_reconcile_.empty()) {
+    usage_reconciliation_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromMilliseconds(kReconcileUsageDelay),
+        this, &QuotaManager::ReconcileUsage);
+  }
+
   histogram_timer_.Start(FROM_HERE,
                          base::TimeDelta::FromMilliseconds(
                              kReportHistogramInterval),
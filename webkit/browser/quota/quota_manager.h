@@ -271,6 +271,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
   typedef QuotaDatabase::OriginInfoTableEntry OriginInfoTableEntry;
   typedef std::vector<QuotaTableEntry> QuotaTableEntries;
   typedef std::vector<OriginInfoTableEntry> OriginInfoTableEntries;
+  typedef std::map<StorageType, OriginUsageByClient> UsageLedgers;
 
   // Function pointer type used to store the function which returns the
   // available disk space for the disk containing the given FilePath.
@@ -332,6 +333,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   void DidOriginDataEvicted(QuotaStatusCode status);
 
+  // Persists the usage trackers' caches for the next session to start from.
+  void SaveUsageLedgers();
+
+  // Gathers usage again for the trackers whose cache was seeded from the
+  // ledger on startup.
+  void ReconcileUsage();
+
   void ReportHistogram();
   void DidGetTemporaryGlobalUsageForHistogram(int64 usage,
                                               int64 unlimited_usage);
@@ -361,6 +369,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
                                  bool success);
   void DidInitialize(int64* temporary_quota_override,
                      int64* desired_available_space,
+                     const UsageLedgers* usage_ledgers,
                      bool success);
   void DidGetLRUOrigin(const GURL* origin,
                        bool success);
@@ -420,6 +429,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   base::RepeatingTimer<QuotaManager> histogram_timer_;
 
+  std::set<StorageType> usage_types_to_reconcile_;
+  base::OneShotTimer<QuotaManager> usage_reconciliation_timer_;
+
   // Pointer to the function used to get the available disk space. This is
   // overwritten by QuotaManagerTest in order to attain a deterministic reported
   // value. The default value points to base::SysInfo::AmountOfFreeDiskSpace.
@@ -158,13 +158,16 @@ void QuotaTemporaryStorageEvictor::ConsiderEviction() {
   // Get usage and disk space, then continue.
   quota_eviction_handler_->GetUsageAndQuotaForEviction(
       base::Bind(&QuotaTemporaryStorageEvictor::OnGotUsageAndQuotaForEviction,
-                 weak_factory_.GetWeakPtr()));
+                 weak_factory_.GetWeakPtr(), base::TimeTicks::Now()));
 }
 
 void QuotaTemporaryStorageEvictor::OnGotUsageAndQuotaForEviction(
+    base::TimeTicks request_time,
     QuotaStatusCode status,
     const UsageAndQuota& qau) {
   DCHECK(CalledOnValidThread());
+  UMA_HISTOGRAM_TIMES("Quota.TimeToGetUsageAndQuotaForEviction",
+                      base::TimeTicks::Now() - request_time);
 
   int64 usage = qau.global_limited_usage;
   DCHECK_GE(usage, 0);
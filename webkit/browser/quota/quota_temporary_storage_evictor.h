@@ -89,6 +89,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaTemporaryStorageEvictor
   void StartEvictionTimerWithDelay(int delay_ms);
   void ConsiderEviction();
   void OnGotUsageAndQuotaForEviction(
+      base::TimeTicks request_time,
       QuotaStatusCode status,
       const UsageAndQuota& quota_and_usage);
   void OnGotLRUOrigin(const GURL& origin);
@@ -216,6 +216,36 @@ void UsageTracker::SetUsageCacheEnabled(QuotaClient::ID client_id,
   client_tracker->SetUsageCacheEnabled(origin, enabled);
 }
 
+bool UsageTracker::GetCachedUsageByClient(OriginUsageByClient* usage) const {
+  DCHECK(usage);
+  usage->clear();
+  for (ClientTrackerMap::const_iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    if (!iter->second->GetCachedUsage(&(*usage)[iter->first]))
+      return false;
+  }
+  return true;
+}
+
+void UsageTracker::SeedUsageCache(const OriginUsageByClient& usage) {
+  // A client missing from |usage| had no origins.
+  const std::map<GURL, int64> no_usage;
+  for (ClientTrackerMap::iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    OriginUsageByClient::const_iterator found = usage.find(iter->first);
+    iter->second->SeedUsageCache(found != usage.end() ? found->second
+                                                      : no_usage);
+  }
+}
+
+void UsageTracker::ResetUsageCache() {
+  DCHECK(!IsWorking());
+  for (ClientTrackerMap::iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    iter->second->ResetUsageCache();
+  }
+}
+
 void UsageTracker::AccumulateClientGlobalLimitedUsage(AccumulateInfo* info,
                                                       int64 limited_usage) {
   info->usage += limited_usage;
@@ -431,6 +461,47 @@ void ClientUsageTracker::SetUsageCacheEnabled(const GURL& origin,
   }
 }
 
+bool ClientUsageTracker::GetCachedUsage(std::map<GURL, int64>* usage) const {
+  DCHECK(usage);
+  // Usage of non-cached origins is never known, and a host whose usage is
+  // being gathered may not be cached yet.
+  if (!global_usage_retrieved_ ||
+      !non_cached_limited_origins_by_host_.empty() ||
+      !non_cached_unlimited_origins_by_host_.empty() ||
+      host_usage_accumulators_.HasAnyCallbacks())
+    return false;
+
+  for (HostUsageMap::const_iterator host_iter = cached_usage_by_host_.begin();
+       host_iter != cached_usage_by_host_.end(); ++host_iter) {
+    usage->insert(host_iter->second.begin(), host_iter->second.end());
+  }
+  return true;
+}
+
+void ClientUsageTracker::SeedUsageCache(const std::map<GURL, int64>& usage) {
+  // Whatever has been gathered from the client is more recent than |usage|.
+  if (global_usage_retrieved_ || !cached_hosts_.empty() ||
+      host_usage_accumulators_.HasAnyCallbacks())
+    return;
+
+  for (std::map<GURL, int64>::const_iterator iter = usage.begin();
+       iter != usage.end(); ++iter) {
+    if (!IsUsageCacheEnabledForOrigin(iter->first))
+      continue;
+    AddCachedOrigin(iter->first, std::max<int64>(iter->second, 0));
+    AddCachedHost(net::GetHostOrSpecFromURL(iter->first));
+  }
+  global_usage_retrieved_ = true;
+}
+
+void ClientUsageTracker::ResetUsageCache() {
+  global_limited_usage_ = 0;
+  global_unlimited_usage_ = 0;
+  global_usage_retrieved_ = false;
+  cached_hosts_.clear();
+  cached_usage_by_host_.clear();
+}
+
 void ClientUsageTracker::AccumulateLimitedOriginUsage(
     AccumulateInfo* info,
     const UsageCallback& callback,
@@ -47,7 +47,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT UsageTracker : public QuotaTaskObserver {
   void GetCachedHostsUsage(std::map<std::string, int64>* host_usage) const;
   void GetCachedOrigins(std::set<GURL>* origins) const;
   bool IsWorking() const {
-    return global_usage_callbacks_.HasCallbacks() ||
+    return global_limited_usage_callbacks_.HasCallbacks() ||
+           global_usage_callbacks_.HasCallbacks() ||
            host_usage_callbacks_.HasAnyCallbacks();
   }
 
@@ -55,6 +56,18 @@ class WEBKIT_STORAGE_BROWSER_EXPORT UsageTracker : public QuotaTaskObserver {
                             const GURL& origin,
                             bool enabled);
 
+  // Copies every client's cached per-origin usage to |usage|. Returns false
+  // if some client's cache does not cover all of its origins.
+  bool GetCachedUsageByClient(OriginUsageByClient* usage) const;
+
+  // Fills the caches of clients which have not gathered any usage yet from
+  // |usage|, as if the origins in it had been scanned.
+  void SeedUsageCache(const OriginUsageByClient& usage);
+
+  // Drops all cached usage, so that it is gathered from the clients again.
+  // Must not be called while IsWorking().
+  void ResetUsageCache();
+
  private:
   struct AccumulateInfo {
     AccumulateInfo() : pending_clients(0), usage(0), unlimited_usage(0) {}
@@ -114,6 +127,9 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
                               std::vector<GURL>* origins_not_in_cache);
   bool IsUsageCacheEnabledForOrigin(const GURL& origin) const;
   void SetUsageCacheEnabled(const GURL& origin, bool enabled);
+  bool GetCachedUsage(std::map<GURL, int64>* usage) const;
+  void SeedUsageCache(const std::map<GURL, int64>& usage);
+  void ResetUsageCache();
 
  private:
   typedef CallbackQueueMap<HostUsageAccumulator, std::string,
@@ -324,5 +324,45 @@ TEST_F(UsageTrackerTest, LimitedGlobalUsageTest) {
   EXPECT_EQ(2 + 32, unlimited_usage);
 }
 
+TEST_F(UsageTrackerTest, SeedAndResetUsageCache) {
+  const GURL kOrigin1("http://a.com");
+  const GURL kOrigin2("http://b.com");
+
+  OriginUsageByClient usage;
+  EXPECT_FALSE(usage_tracker()->GetCachedUsageByClient(&usage));
+
+  // The client has more data than the ledger knows about, e.g. because it was
+  // written by a session that crashed; the seeded cache still answers.
+  UpdateUsageWithoutNotification(kOrigin1, 10);
+  UpdateUsageWithoutNotification(kOrigin2, 20);
+  usage[QuotaClient::kFileSystem][kOrigin1] = 10;
+  usage_tracker()->SeedUsageCache(usage);
+
+  int64 total_usage = 0;
+  int64 unlimited_usage = 0;
+  int64 host_usage = 0;
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(10, total_usage);
+  GetHostUsage(net::GetHostOrSpecFromURL(kOrigin1), &host_usage);
+  EXPECT_EQ(10, host_usage);
+
+  UpdateUsage(kOrigin1, 5);
+  OriginUsageByClient cached_usage;
+  EXPECT_TRUE(usage_tracker()->GetCachedUsageByClient(&cached_usage));
+  EXPECT_EQ(15, cached_usage[QuotaClient::kFileSystem][kOrigin1]);
+
+  // Resetting the cache gathers usage from the client again.
+  usage_tracker()->ResetUsageCache();
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(15 + 20, total_usage);
+  EXPECT_TRUE(usage_tracker()->GetCachedUsageByClient(&cached_usage));
+  EXPECT_EQ(2u, cached_usage[QuotaClient::kFileSystem].size());
+
+  // Seeding after usage has been gathered has no effect.
+  usage_tracker()->SeedUsageCache(usage);
+  GetGlobalUsage(&total_usage, &unlimited_usage);
+  EXPECT_EQ(15 + 20, total_usage);
+}
+
 
 }  // namespace quota
@@ -4,6 +4,8 @@
 
 #include "webkit/common/blob/blob_data.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
@@ -11,9 +13,10 @@
 
 namespace webkit_blob {
 
-BlobData::BlobData() {}
+BlobData::BlobData() : shared_data_length_(0) {}
 BlobData::BlobData(const std::string& uuid)
-    : uuid_(uuid) {
+    : uuid_(uuid),
+      shared_data_length_(0) {
 }
 
 BlobData::~BlobData() {}
@@ -24,6 +27,18 @@ void BlobData::AppendData(const char* data, size_t length) {
   items_.back().SetToBytes(data, length);
 }
 
+void BlobData::AppendSharedData(const char* data, size_t length,
+                                BlobData* owner) {
+  DCHECK(length > 0);
+  DCHECK(owner);
+  items_.push_back(Item());
+  items_.back().SetToSharedBytes(data, length);
+  if (std::find(shared_data_owners_.begin(), shared_data_owners_.end(),
+                owner) == shared_data_owners_.end())
+    shared_data_owners_.push_back(owner);
+  shared_data_length_ += length;
+}
+
 void BlobData::AppendFile(const base::FilePath& file_path,
                           uint64 offset, uint64 length,
                           const base::Time& expected_modification_time) {
@@ -57,7 +72,7 @@ int64 BlobData::GetMemoryUsage() const {
     if (iter->type() == Item::TYPE_BYTES)
       memory += iter->length();
   }
-  return memory;
+  return memory - shared_data_length_;
 }
 
 }  // namespace webkit_blob